@@ -9,7 +9,18 @@
         "src/connection.cpp",
         "src/stmt.cpp",
         "src/sacapidll.cpp",
-        "src/async_workers.cpp"
+        "src/async_workers.cpp",
+        "src/result_set.cpp",
+        "src/query_options.cpp",
+        "src/cursor.cpp",
+        "src/lob.cpp",
+        "src/temporal.cpp",
+        "src/arrow.cpp",
+        "src/export.cpp",
+        "src/batch_params.cpp",
+        "src/stmt_params.cpp",
+        "src/param_stream.cpp",
+        "src/executor.cpp"
       ],
       "include_dirs": [
           "src/h",
@@ -10,6 +10,10 @@
 
 import assert from "assert"
 import crypto from "crypto"
+import fs from "fs"
+import os from "os"
+import path from "path"
+import { Readable } from "stream"
 import { config } from "dotenv"
 
 config()
@@ -32,7 +36,7 @@ const multiResultProcName = 'GetMultipleResults'
 
 async function testCreateTable(db: Connection) {
   console.time('Create Table Duration')
-  console.log(`\n[3/10] Creating test table '${testTableName}'...`)
+  console.log(`\n[3/11] Creating test table '${testTableName}'...`)
   await db.exec(`
       CREATE TABLE ${testTableName} (
         id_pk INT PRIMARY KEY,
@@ -70,7 +74,7 @@ async function testCreateTable(db: Connection) {
 
 async function testInsertAndCommit(db: Connection) {
   console.time('Insert and Commit Duration')
-  console.log('\n[4/10] Testing INSERT and COMMIT...')
+  console.log('\n[4/11] Testing INSERT and COMMIT...')
   const uuid = crypto.randomUUID()
   const wktGeometry = 'POINT (10 20)'
   const xmlData = '<root><item id="1">test</item></root>'
@@ -106,7 +110,7 @@ async function testInsertAndCommit(db: Connection) {
 
 async function testRollback(db: Connection) {
   console.time('Rollback Duration')
-  console.log(`\n[5/10] Testing ROLLBACK...`)
+  console.log(`\n[5/11] Testing ROLLBACK...`)
   await db.exec(`INSERT INTO ${testTableName} (id_pk, c_varchar) VALUES (?, ?)`, [2, 'To be rolled back'])
   await db.rollback()
   console.log('    Rollback successful.')
@@ -125,7 +129,7 @@ async function testRollback(db: Connection) {
 
 async function testPreparedStatements(db: Connection) {
   console.time('Prepared Statements Duration')
-  console.log('\n[6/10] Testing Prepared Statements...')
+  console.log('\n[6/11] Testing Prepared Statements...')
   const insertSQL = `INSERT INTO ${testTableName} (id_pk, c_varchar, c_integer) VALUES (?, ?, ?)`
   const stmt = await db.prepare(insertSQL)
   if (!stmt) {
@@ -148,6 +152,104 @@ async function testPreparedStatements(db: Connection) {
   assert.strictEqual(result[0].c_integer, 123, 'Prepared statement data mismatch.')
   console.log('    Prepared statement data verified.')
 
+  const inserted = await stmt.execBatch([
+    [100, 'Batch row 1', 1],
+    [101, null, 2],
+    [102, 'Batch row 3', null]
+  ])
+  assert.strictEqual(inserted, 3, 'execBatch should report every inserted row.')
+  const batchRows = await db.exec(`SELECT id_pk, c_varchar, c_integer FROM ${testTableName} WHERE id_pk >= 100 ORDER BY id_pk`)
+  assert.deepStrictEqual(batchRows, [
+    { id_pk: 100, c_varchar: 'Batch row 1', c_integer: 1 },
+    { id_pk: 101, c_varchar: null, c_integer: 2 },
+    { id_pk: 102, c_varchar: 'Batch row 3', c_integer: null }
+  ], 'execBatch data mismatch.')
+  await db.rollback()
+  console.log('    execBatch verified and rolled back.')
+
+  const insertedColumns = await stmt.execBatchColumns(
+    { id: Int32Array.from([110, 111]), name: ['Column row 1', null], value: Int32Array.from([7, 8]) },
+    { value: Uint8Array.from([0, 1]) }
+  )
+  assert.strictEqual(insertedColumns, 2, 'execBatchColumns should report every inserted row.')
+  const columnRows = await db.exec(`SELECT id_pk, c_varchar, c_integer FROM ${testTableName} WHERE id_pk >= 110 ORDER BY id_pk`)
+  assert.deepStrictEqual(columnRows, [
+    { id_pk: 110, c_varchar: 'Column row 1', c_integer: 7 },
+    { id_pk: 111, c_varchar: null, c_integer: null }
+  ], 'execBatchColumns data mismatch.')
+  await db.rollback()
+  console.log('    execBatchColumns verified and rolled back.')
+
+  const floatStmt = await db.prepare(`INSERT INTO ${testTableName} (id_pk, c_double) VALUES (?, ?)`)
+  await floatStmt.execBatchColumns({ id: Int32Array.from([112, 113]), value: Float32Array.from([1.5, -2.25]) })
+  const floatRows = await db.exec(`SELECT c_double FROM ${testTableName} WHERE id_pk IN (112, 113) ORDER BY id_pk`)
+  if (typeof floatRows === 'number') {
+    assert.fail('Float column query returned an affected row count.')
+  }
+  assert.deepStrictEqual(floatRows.map((row) => row.c_double), [1.5, -2.25], 'Float32Array column data mismatch.')
+  await floatStmt.drop()
+  await db.rollback()
+  console.log('    Float32Array column verified and rolled back.')
+
+  for (const [id, name, value] of [[120, 'Re-executed', 1], [121, 'A much longer value than before', null], [122, null, '3']]) {
+    await stmtExec([id, name, value])
+  }
+  const reusedRows = await db.exec(`SELECT id_pk, c_varchar, c_integer FROM ${testTableName} WHERE id_pk >= 120 ORDER BY id_pk`)
+  assert.deepStrictEqual(reusedRows, [
+    { id_pk: 120, c_varchar: 'Re-executed', c_integer: 1 },
+    { id_pk: 121, c_varchar: 'A much longer value than before', c_integer: null },
+    { id_pk: 122, c_varchar: null, c_integer: 3 }
+  ], 'Re-executed statement data mismatch.')
+  await db.rollback()
+  console.log('    Re-executed statement verified and rolled back.')
+
+  const blob = crypto.randomBytes(200 * 1024)
+  const chunks = [blob.subarray(0, 70000), blob.subarray(70000, 140000), blob.subarray(140000)]
+  await db.exec(`INSERT INTO ${testTableName} (id_pk, c_long_binary, c_long_varchar) VALUES (?, ?, ?)`, [
+    130, Readable.from(chunks), Readable.from(['streamed ', 'text'])
+  ])
+  const streamed = await db.exec(`SELECT c_long_binary, c_long_varchar FROM ${testTableName} WHERE id_pk = 130`)
+  if (typeof streamed === 'number') {
+    assert.fail('Stream parameter query returned an affected row count.')
+  }
+  assert.ok(blob.equals(streamed[0].c_long_binary), 'Streamed LONG BINARY mismatch.')
+  assert.strictEqual(streamed[0].c_long_varchar, 'streamed text', 'Streamed LONG VARCHAR mismatch.')
+  await db.rollback()
+  console.log('    Stream parameters verified and rolled back.')
+
+  const streamStmt = await db.prepare(`INSERT INTO ${testTableName} (id_pk, c_long_binary) VALUES (?, ?)`)
+  async function * cancelled () {
+    yield blob.subarray(0, 70000)
+    throw new Error('Source cancelled')
+  }
+  await assert.rejects(streamStmt.exec([131, cancelled()]), /Source cancelled/, 'A failed stream should reject the exec.')
+  await streamStmt.exec([131, Readable.from(chunks)])
+  const resumed = await db.exec(`SELECT c_long_binary FROM ${testTableName} WHERE id_pk = 131`)
+  if (typeof resumed === 'number') {
+    assert.fail('Resumed stream statement query returned an affected row count.')
+  }
+  assert.ok(blob.equals(resumed[0].c_long_binary), 'A statement should be reusable after a cancelled stream.')
+  await streamStmt.drop()
+  await db.rollback()
+  console.log('    Cancelled stream parameter verified and rolled back.')
+
+  const typed = await db.prepare(`INSERT INTO ${testTableName} (id_pk, c_varchar, c_double) VALUES (?, ?, ?)`, {
+    types: ['int32', 'string', 'double']
+  })
+  await typed.exec([140, 42, 3])
+  await typed.exec([141, null, 2.5])
+  await assert.rejects(typed.exec([142, 'text', 'not a number']), /must be a number/, 'A mistyped value should be rejected.')
+  await assert.rejects(typed.exec([3e9, 'text', 1]), /must be an integer in the range of int32/, 'An out-of-range integer should be rejected.')
+  await assert.rejects(typed.exec([1.5, 'text', 1]), /must be an integer in the range of int32/, 'A fractional integer should be rejected.')
+  const typedRows = await db.exec(`SELECT id_pk, c_varchar, c_double FROM ${testTableName} WHERE id_pk >= 140 ORDER BY id_pk`)
+  assert.deepStrictEqual(typedRows, [
+    { id_pk: 140, c_varchar: '42', c_double: 3 },
+    { id_pk: 141, c_varchar: null, c_double: 2.5 }
+  ], 'Typed statement data mismatch.')
+  await typed.drop()
+  await db.rollback()
+  console.log('    Parameter type signature verified and rolled back.')
+
   await stmtDrop()
   console.log('    Statement dropped.')
   console.timeEnd('Prepared Statements Duration')
@@ -155,7 +257,7 @@ async function testPreparedStatements(db: Connection) {
 
 async function testCreateAndExecuteProcedures(db: Connection) {
   console.time('Create and Execute Procedures Duration')
-  console.log(`\n[7/10] Creating and testing procedures...`)
+  console.log(`\n[7/11] Creating and testing procedures...`)
   await db.exec(`
       CREATE PROCEDURE ${testProcName}(IN prod_id INT)
       RESULT (res_varchar VARCHAR(100), res_double DOUBLE)
@@ -199,7 +301,7 @@ async function testCreateAndExecuteProcedures(db: Connection) {
 
 async function testMultipleResultSets(db: Connection) {
   console.time('Multiple Result Sets Duration')
-  console.log('\n[8/10] Testing multiple result sets...')
+  console.log('\n[8/11] Testing multiple result sets...')
   await db.exec(`
         CREATE PROCEDURE ${multiResultProcName}()
         BEGIN
@@ -250,9 +352,185 @@ async function testMultipleResultSets(db: Connection) {
   console.timeEnd('Multiple Result Sets Duration')
 }
 
+async function testResultOptions(db: Connection) {
+  console.time('Result Options Duration')
+  console.log('\n[9/11] Testing result options...')
+  const arrayResult = await db.exec(
+    `SELECT id_pk, c_varchar FROM ${testTableName} WHERE id_pk IN (1, 3) ORDER BY id_pk`,
+    [],
+    { rowMode: 'array' }
+  )
+  if (typeof arrayResult === 'number') {
+    assert.fail('Array mode returned an affected row count.')
+  }
+  assert.deepStrictEqual(arrayResult.columns.map((c) => c.name), ['id_pk', 'c_varchar'], 'Array mode column names mismatch.')
+  assert.deepStrictEqual(arrayResult.rows, [[1, 'Updated First Entry'], [3, 'Prepared Statement']], 'Array mode rows mismatch.')
+  console.log('    Array row mode verified.')
+
+  const columnar = await db.exec(
+    `SELECT id_pk, c_varchar FROM ${testTableName} WHERE id_pk IN (1, 3) ORDER BY id_pk`,
+    [],
+    { rowMode: 'columnar' }
+  )
+  if (typeof columnar === 'number') {
+    assert.fail('Columnar mode returned an affected row count.')
+  }
+  assert.strictEqual(columnar.rowCount, 2, 'Columnar mode row count mismatch.')
+  const [idColumn, textColumn] = columnar.columns
+  assert.deepStrictEqual(Array.from(idColumn.values ?? []), [1, 3], 'Columnar integer values mismatch.')
+  assert.strictEqual(idColumn.nulls[0], 0, 'Columnar null bitmap should be clear.')
+  const text = Buffer.from(textColumn.data?.buffer ?? new ArrayBuffer(0), textColumn.data?.byteOffset, textColumn.data?.byteLength)
+  const offsets = textColumn.offsets ?? new Uint32Array(0)
+  assert.strictEqual(text.toString('utf8', offsets[1], offsets[2]), 'Prepared Statement', 'Columnar string data mismatch.')
+  console.log('    Columnar row mode verified.')
+
+  const interned = await db.exec(
+    "SELECT IF MOD(row_num, 2) = 0 THEN 'even' ELSE 'odd' ENDIF AS parity FROM sa_rowgenerator(1, 4) ORDER BY row_num",
+    [],
+    { rowMode: 'columnar', internStrings: true }
+  )
+  if (typeof interned === 'number') {
+    assert.fail('Columnar mode returned an affected row count.')
+  }
+  assert.deepStrictEqual(interned.columns[0].dictionary, ['odd', 'even'], 'Interned dictionary mismatch.')
+  assert.deepStrictEqual(Array.from(interned.columns[0].codes ?? []), [0, 1, 0, 1], 'Interned codes mismatch.')
+  console.log('    String interning verified.')
+
+  const big = await db.exec(
+    'SELECT CAST(9007199254740993 AS BIGINT) AS big, CAST(? AS BIGINT) AS param',
+    [-9007199254740993n],
+    { int64: 'bigint' }
+  )
+  if (typeof big === 'number') {
+    assert.fail('int64 mode returned an affected row count.')
+  }
+  assert.strictEqual(big[0].big, 9007199254740993n, 'BIGINT should be returned exactly as a BigInt.')
+  assert.strictEqual(big[0].param, -9007199254740993n, 'BigInt parameter should round-trip exactly.')
+  const bigText = await db.exec('SELECT CAST(9007199254740993 AS BIGINT) AS big', [], { int64: 'string' })
+  if (typeof bigText === 'number') {
+    assert.fail('int64 mode returned an affected row count.')
+  }
+  assert.strictEqual(bigText[0].big, '9007199254740993', 'BIGINT should be returned exactly as a string.')
+  console.log('    64-bit integer modes verified.')
+
+  const dated = await db.exec(
+    "SELECT CAST('2024-02-29 13:45:10.123' AS TIMESTAMP) AS ts, CAST('2024-02-29' AS DATE) AS d",
+    [],
+    { dates: 'date' }
+  )
+  if (typeof dated === 'number') {
+    assert.fail('dates mode returned an affected row count.')
+  }
+  assert.ok(dated[0].ts instanceof Date, 'TIMESTAMP should be returned as a Date.')
+  assert.strictEqual(dated[0].ts.getTime(), new Date(2024, 1, 29, 13, 45, 10, 123).getTime(), 'TIMESTAMP value mismatch.')
+  const epoch = await db.exec("SELECT CAST('2024-02-29' AS DATE) AS d", [], { dates: 'epoch' })
+  if (typeof epoch === 'number') {
+    assert.fail('dates mode returned an affected row count.')
+  }
+  assert.strictEqual(epoch[0].d, Date.UTC(2024, 1, 29), 'DATE epoch value mismatch.')
+  console.log('    Date decoding verified.')
+
+  const limited = await db.exec(`SELECT id_pk FROM ${testTableName} ORDER BY id_pk`, [], { maxRows: 1 })
+  assert.deepStrictEqual(limited, [{ id_pk: 1 }], 'maxRows should stop after the first row.')
+  for (const maxRows of [-1, 2 ** 32, 1.5]) {
+    await assert.rejects(db.exec('SELECT 1', [], { maxRows }), TypeError, `maxRows ${maxRows} should be rejected.`)
+  }
+  const first = await db.queryOne(`SELECT id_pk, c_varchar FROM ${testTableName} WHERE id_pk = ?`, [3])
+  assert.deepStrictEqual(first, { id_pk: 3, c_varchar: 'Prepared Statement' }, 'queryOne row mismatch.')
+  const none = await db.queryOne(`SELECT id_pk FROM ${testTableName} WHERE id_pk = ?`, [-1])
+  assert.strictEqual(none, null, 'queryOne should return null when there are no rows.')
+  const count: number = await db.queryScalar(`SELECT COUNT(*) FROM ${testTableName}`)
+  assert.strictEqual(count, 2, 'queryScalar value mismatch.')
+  console.log('    maxRows, queryOne and queryScalar verified.')
+
+  const arrow = await db.exec(`SELECT id_pk, c_varchar FROM ${testTableName} ORDER BY id_pk`, [], { format: 'arrow' })
+  if (typeof arrow === 'number') {
+    assert.fail('format: arrow returned an affected row count.')
+  }
+  assert.ok(Buffer.isBuffer(arrow), 'format: arrow should return a Buffer.')
+  assert.strictEqual(arrow.readUInt32LE(0), 0xFFFFFFFF, 'Arrow stream should start with a continuation marker.')
+  assert.strictEqual(arrow.readUInt32LE(arrow.length - 8), 0xFFFFFFFF, 'Arrow stream should end with the end-of-stream marker.')
+  assert.strictEqual(arrow.readUInt32LE(arrow.length - 4), 0, 'Arrow stream should end with the end-of-stream marker.')
+  assert.ok(arrow.includes('Prepared Statement'), 'Arrow stream should carry the string data.')
+  const arrowTs = await db.exec("SELECT CAST('2024-01-02 03:04:05.123456' AS TIMESTAMP) AS ts", [], { format: 'arrow' })
+  const expectedMicros = Buffer.alloc(8)
+  expectedMicros.writeBigInt64LE(1704164645123456n)
+  assert.ok(Buffer.isBuffer(arrowTs) && arrowTs.includes(expectedMicros), 'Arrow TIMESTAMP should hold wall-clock microseconds.')
+  assert.ok(!arrowTs.includes('UTC'), 'Arrow TIMESTAMP should carry no timezone.')
+  console.log('    Arrow output verified.')
+
+  const jsonBody = await db.exec(`SELECT id_pk, c_varchar, c_double FROM ${testTableName} ORDER BY id_pk`, [], { format: 'json' })
+  const jsonRows = await db.exec(`SELECT id_pk, c_varchar, c_double FROM ${testTableName} ORDER BY id_pk`)
+  if (typeof jsonBody === 'number') {
+    assert.fail('format: json returned an affected row count.')
+  }
+  assert.ok(Buffer.isBuffer(jsonBody), 'format: json should return a Buffer.')
+  assert.strictEqual(jsonBody.toString('utf8'), JSON.stringify(jsonRows), 'JSON output should match JSON.stringify of the rows.')
+  const doublesSql = 'SELECT CAST(1e21 AS DOUBLE) AS big, CAST(1.5e20 AS DOUBLE) AS wide, CAST(1.25e-7 AS DOUBLE) AS tiny, CAST(0.000123 AS DOUBLE) AS small'
+  const jsonDoubles = await db.exec(doublesSql, [], { format: 'json' })
+  if (typeof jsonDoubles === 'number') {
+    assert.fail('format: json returned an affected row count.')
+  }
+  assert.strictEqual(jsonDoubles.toString('utf8'), JSON.stringify(await db.exec(doublesSql)), 'JSON doubles should be laid out like JSON.stringify.')
+  console.log('    JSON output verified.')
+
+  const csvPath = path.join(os.tmpdir(), `${testTableName}.csv`)
+  const exported = await db.exportToFile(`SELECT id_pk, c_varchar FROM ${testTableName} ORDER BY id_pk`, [], { path: csvPath })
+  assert.strictEqual(exported, 2, 'exportToFile should report the rows written.')
+  const csvLines = fs.readFileSync(csvPath, 'utf8').split('\r\n')
+  assert.strictEqual(csvLines[0], 'id_pk,c_varchar', 'CSV header mismatch.')
+  assert.strictEqual(csvLines[2], '3,Prepared Statement', 'CSV row mismatch.')
+  const ndjsonPath = path.join(os.tmpdir(), `${testTableName}.ndjson`)
+  await db.exportToFile(`SELECT id_pk, c_varchar FROM ${testTableName} WHERE id_pk = ?`, [3], { format: 'ndjson', path: ndjsonPath })
+  const exportedRow = JSON.parse(fs.readFileSync(ndjsonPath, 'utf8').trim())
+  assert.deepStrictEqual(exportedRow, { id_pk: 3, c_varchar: 'Prepared Statement' }, 'NDJSON row mismatch.')
+  fs.unlinkSync(csvPath)
+  fs.unlinkSync(ndjsonPath)
+  console.log('    exportToFile verified.')
+
+  const cursor = await db.exec(
+    `SELECT id_pk FROM ${testTableName} ORDER BY id_pk`,
+    [],
+    { cursor: true, fetchSize: 1 }
+  )
+  if (typeof cursor === 'number') {
+    assert.fail('Cursor mode returned an affected row count.')
+  }
+  const ids: number[] = []
+  for await (const row of cursor) {
+    ids.push(row.id_pk)
+  }
+  assert.deepStrictEqual(ids, [1, 3], 'Cursor iteration mismatch.')
+  assert.ok(cursor.done, 'Cursor should be done after iteration.')
+  for (const rows of [0, 2 ** 32, 1.5]) {
+    await assert.rejects(db.exec('SELECT 1', [], { cursor: true, fetchSize: rows }), TypeError, `fetchSize ${rows} should be rejected.`)
+    await assert.rejects(cursor.fetch(rows), TypeError, `fetch(${rows}) should be rejected.`)
+  }
+  console.log('    Cursor iteration verified.')
+  const lobCursor = await db.exec(
+    "SELECT CAST(REPEAT('ab', 50000) AS LONG BINARY) AS doc",
+    [],
+    { cursor: true, lobs: 'stream' }
+  )
+  if (typeof lobCursor === 'number') {
+    assert.fail('Cursor mode returned an affected row count.')
+  }
+  for await (const row of lobCursor) {
+    const chunks: Buffer[] = []
+    for await (const chunk of row.doc) {
+      chunks.push(chunk as Buffer)
+    }
+    const doc = Buffer.concat(chunks)
+    assert.strictEqual(doc.length, 100000, 'Streamed LOB length mismatch.')
+    assert.strictEqual(doc.toString('latin1', 0, 4), 'abab', 'Streamed LOB content mismatch.')
+  }
+  console.log('    LOB streaming verified.')
+  console.timeEnd('Result Options Duration')
+}
+
 async function testErrorHandling(db: Connection) {
   console.time('Error Handling Duration')
-  console.log('\n[9/10] Testing Error Handling...')
+  console.log('\n[10/11] Testing Error Handling...')
   try {
     await db.exec('SELECT * FROM THIS_TABLE_DOES_NOT_EXIST')
     throw new Error('Query should have failed but it succeeded.')
@@ -276,6 +554,7 @@ async function runTests(db: Connection) {
   await testPreparedStatements(db)
   await testCreateAndExecuteProcedures(db)
   await testMultipleResultSets(db)
+  await testResultOptions(db)
   await testErrorHandling(db)
 }
 
@@ -286,13 +565,13 @@ async function main() {
   try {
     console.log('--- TEST SUITE START ---')
     console.time('Connection Duration')
-    console.log('\n[1/10] Connecting to database...')
+    console.log('\n[1/11] Connecting to database...')
     await db.connect(connParams)
     console.log('    Connection successful!')
     console.timeEnd('Connection Duration')
 
     console.time('Cleanup Duration')
-    console.log('\n[2/10] Cleaning up previous test objects...')
+    console.log('\n[2/11] Cleaning up previous test objects...')
     await db.exec(`DROP PROCEDURE IF EXISTS ${testProcName}`)
     await db.exec(`DROP PROCEDURE IF EXISTS ${updateProcName}`)
     await db.exec(`DROP PROCEDURE IF EXISTS ${multiResultProcName}`)
@@ -307,7 +586,7 @@ async function main() {
     console.error(error)
   } finally {
     console.time('Disconnection Duration')
-    console.log('\n[10/10] Disconnecting...')
+    console.log('\n[11/11] Disconnecting...')
     await db.disconnect()
     console.log('    Disconnected.')
     console.timeEnd('Disconnection Duration')
@@ -5,24 +5,201 @@ export interface ConnectionParams {
   [key: string]: string | undefined;
 }
 
-export type QueryValue = string | number | Buffer | null;
+/** A `Readable` or other async iterable is streamed to the server chunk by chunk. */
+export type QueryValue = string | number | bigint | Buffer | AsyncIterable<Buffer | Uint8Array | string> | null;
 export type QueryParams = QueryValue[];
 export type QueryResult = Record<string, any>[];
 
+/** A parameter type for the `types` signature of `prepare`. */
+export type ParamType =
+    | 'int8' | 'uint8' | 'int16' | 'uint16' | 'int32' | 'uint32' | 'int64' | 'uint64'
+    | 'float' | 'double' | 'string' | 'binary';
+
+export interface PrepareOptions {
+    /**
+     * One type per parameter. Values are converted to these types without being inspected,
+     * the way a typed array stores numbers, and a value of the wrong kind fails the call.
+     */
+    types?: ParamType[];
+}
+
+/** One parameter's values for `execBatchColumns`: a typed array bound in place, or strings (`null` binds NULL). */
+export type BatchColumn =
+    | Int8Array | Uint8Array | Uint8ClampedArray | Int16Array | Uint16Array | Int32Array | Uint32Array
+    | Float32Array | Float64Array | BigInt64Array | BigUint64Array
+    | (string | null | undefined)[];
+/** Per-row NULL flags keyed by column name; an `Int32Array` is bound in place. */
+export type BatchNulls = Record<string, Int32Array | Uint8Array | ArrayLike<boolean | number>>;
+
+export interface ColumnInfo {
+  name: string;
+  type: 'int32' | 'uint32' | 'int64' | 'uint64' | 'double' | 'string' | 'binary' | 'timestamp' | 'lob' | 'unsupported';
+  /** The `a_sqlany_native_type` code reported by the server. */
+  nativeType: number;
+  nullable: boolean;
+}
+
+export interface ArrayResult {
+  columns: ColumnInfo[];
+  rows: any[][];
+}
+
+export interface ColumnData extends ColumnInfo {
+  /** Bit `i % 8` of byte `i >> 3` is set when row `i` is NULL. */
+  nulls: Uint8Array;
+  /** Numeric columns, and DATE / TIMESTAMP columns as epoch milliseconds with `dates`: one element per row. */
+  values?: Int32Array | Uint32Array | BigInt64Array | BigUint64Array | Float64Array;
+  /** String and binary columns: row `i` spans `data[offsets[i]]` to `data[offsets[i + 1]]`. */
+  offsets?: Uint32Array;
+  data?: Uint8Array;
+  /** String columns with `internStrings`: the distinct values, and the index into them of each row. */
+  dictionary?: string[];
+  codes?: Uint32Array;
+}
+
+export interface ColumnarResult {
+  rowCount: number;
+  columns: ColumnData[];
+}
+
+export interface ExecOptions {
+  /**
+   * `'object'` (default) returns one object per row, `'array'` returns an `ArrayResult`
+   * and `'columnar'` returns a `ColumnarResult`.
+   */
+  rowMode?: 'object' | 'array' | 'columnar';
+  /** Return a `Cursor` that fetches the result set in batches instead of all at once. */
+  cursor?: boolean;
+  /** Rows fetched per `Cursor.fetch()` call when no count is given. Defaults to 1000. */
+  fetchSize?: number;
+  /** Stop fetching after this many rows; `0` (default) means no limit. */
+  maxRows?: number;
+  /**
+   * `'stream'` returns LONG BINARY / LONG VARCHAR cells as a `LobStream` read in chunks.
+   * Requires `cursor: true`; such cursors fetch one row per batch.
+   */
+  lobs?: 'buffer' | 'stream';
+  /**
+   * JavaScript type of BIGINT / UNSIGNED BIGINT values in object and array rows. Defaults to
+   * `'number'`, which loses precision above 2^53. Columnar results always use BigInt arrays.
+   */
+  int64?: 'number' | 'bigint' | 'string';
+  /**
+   * JavaScript type of DATE and TIMESTAMP values: `'string'` (default), `Date` objects, or epoch
+   * milliseconds. Values are read as UTC unless they carry an offset.
+   */
+  dates?: 'string' | 'date' | 'epoch';
+  /** Create one string per distinct value of each string column and share it between rows. */
+  internStrings?: boolean;
+  /**
+   * Return the result as a `Buffer` encoded on the worker thread: `'arrow'` holds an Apache Arrow
+   * IPC stream (`rowMode`, `int64`, `dates` and `internStrings` are then ignored), `'json'` the
+   * UTF-8 JSON text of the object rows.
+   */
+  format?: 'rows' | 'arrow' | 'json';
+}
+
+export interface ExportOptions {
+  /** File to create or overwrite. */
+  path: string;
+  /** `'csv'` (default) or newline-delimited JSON. */
+  format?: 'csv' | 'ndjson';
+  /** CSV only: write the column names as the first line. Defaults to `true`. */
+  header?: boolean;
+}
+
+/** A streamed LOB cell. It can only be read until the cursor moves to the next row. */
+export interface LobStream extends NodeJS.ReadableStream {
+  /** Length of the value as reported by the server, in bytes. */
+  readonly size: number;
+}
+
+export type RowsResult<O extends ExecOptions> =
+  O extends { format: 'arrow' | 'json' } ? Buffer :
+  O extends { rowMode: 'array' } ? ArrayResult :
+  O extends { rowMode: 'columnar' } ? ColumnarResult :
+  QueryResult;
+
+export type ExecResult<O extends ExecOptions> =
+  O extends { cursor: true } ? Cursor<RowsResult<O>> : RowsResult<O>;
+
+/** What iterating a cursor yields: single rows, or whole batches in columnar mode and as Buffers. */
+export type CursorItem<R> =
+  R extends Buffer ? Buffer :
+  R extends ColumnarResult ? ColumnarResult :
+  R extends ArrayResult ? any[] :
+  Record<string, any>;
+
+export class Cursor<R = QueryResult> {
+    /** `true` once the result set has been drained or the cursor has been closed. */
+    readonly done: boolean;
+
+    /**
+     * Fetches the next batch of rows, in the `rowMode` the cursor was opened with.
+     * An empty batch means the result set is drained; the cursor then closes itself.
+     * @param rows Optional maximum number of rows, defaults to the `fetchSize` option.
+     * @param callback Callback function.
+     */
+    fetch(rows: number, callback: (err: Error | null, batch?: R) => void): void;
+    fetch(callback: (err: Error | null, batch?: R) => void): void;
+
+    /**
+     * Releases the result set before it has been drained.
+     * @param callback Callback function.
+     */
+    close(callback: (err: Error | null) => void): void;
+
+    [Symbol.asyncIterator](): AsyncIterableIterator<CursorItem<R>>;
+}
+
 export class Statement {
     /**
      * Executes a prepared statement.
      * @param params Optional array of parameters for the statement.
+     * @param options Optional result options, such as `rowMode`.
      * @param callback Callback function.
      */
     exec(params?: QueryParams, callback?: (err: Error | null, result?: QueryResult | number) => void): void;
+    exec<O extends ExecOptions>(params: QueryParams | null, options: O, callback: (err: Error | null, result?: ExecResult<O> | number) => void): void;
     exec(callback: (err: Error | null, result?: QueryResult | number) => void): void;
 
+    /**
+     * Executes the statement and returns only its first row (`null` if there is none).
+     * Fetching stops after that row. In `rowMode: 'array'` the row is an array.
+     */
+    queryOne(params: QueryParams | null, options: ExecOptions, callback: (err: Error | null, row?: any) => void): void;
+    queryOne(params: QueryParams | null, callback: (err: Error | null, row?: Record<string, any> | null) => void): void;
+    queryOne(callback: (err: Error | null, row?: Record<string, any> | null) => void): void;
+
+    /** Executes the statement and returns the first column of its first row (`null` if there is none). */
+    queryScalar(params: QueryParams | null, options: ExecOptions, callback: (err: Error | null, value?: any) => void): void;
+    queryScalar(params: QueryParams | null, callback: (err: Error | null, value?: any) => void): void;
+    queryScalar(callback: (err: Error | null, value?: any) => void): void;
+
+    /**
+     * Executes the statement once per parameter array, sending many rows per round trip.
+     * Intended for `INSERT` statements.
+     * @param rows One parameter array per execution, all of the same length.
+     * @param callback Called with the total number of affected rows.
+     */
+    execBatch(rows: QueryParams[], callback: (err: Error | null, affectedRows?: number) => void): void;
+
+    /**
+     * Executes the statement once per row of `columns`, binding each property as one parameter
+     * array in property order. Typed arrays are sent without being copied.
+     * @param columns Equally long columns, one per parameter.
+     * @param nulls Optional per-row NULL flags by column name.
+     * @param callback Called with the total number of affected rows.
+     */
+    execBatchColumns(columns: Record<string, BatchColumn>, nulls: BatchNulls | null | undefined, callback: (err: Error | null, affectedRows?: number) => void): void;
+    execBatchColumns(columns: Record<string, BatchColumn>, callback: (err: Error | null, affectedRows?: number) => void): void;
+
     /**
      * For procedures that return multiple result sets, this method advances to the next result set.
      * @param callback Callback function.
      */
     getMoreResults(callback: (err: Error | null, result?: QueryResult) => void): void;
+    getMoreResults<O extends ExecOptions>(options: O, callback: (err: Error | null, result?: ExecResult<O>) => void): void;
 
     /**
      * Frees the resources associated with the prepared statement.
@@ -32,7 +209,8 @@ export class Statement {
 }
 
 export class Connection {
-    constructor();
+    /** @param defaults Options applied to every `exec()` on this connection and its statements. */
+    constructor(defaults?: ExecOptions);
 
     /**
      * Establishes a connection to the database.
@@ -52,16 +230,41 @@ export class Connection {
      * Executes a SQL statement.
      * @param sql The SQL statement to execute.
      * @param params Optional array of parameters.
+     * @param options Optional result options, such as `rowMode`.
      * @param callback Callback function.
      */
     exec(sql: string, params?: QueryParams, callback?: (err: Error | null, result?: QueryResult | number) => void): void;
+    exec<O extends ExecOptions>(sql: string, params: QueryParams | null, options: O, callback: (err: Error | null, result?: ExecResult<O> | number) => void): void;
     exec(sql: string, callback: (err: Error | null, result?: QueryResult | number) => void): void;
 
+    /**
+     * Executes a SQL statement and returns only its first row (`null` if there is none).
+     * Fetching stops after that row. In `rowMode: 'array'` the row is an array.
+     */
+    queryOne(sql: string, params: QueryParams | null, options: ExecOptions, callback: (err: Error | null, row?: any) => void): void;
+    queryOne(sql: string, params: QueryParams | null, callback: (err: Error | null, row?: Record<string, any> | null) => void): void;
+    queryOne(sql: string, callback: (err: Error | null, row?: Record<string, any> | null) => void): void;
+
+    /** Executes a SQL statement and returns the first column of its first row (`null` if there is none). */
+    queryScalar(sql: string, params: QueryParams | null, options: ExecOptions, callback: (err: Error | null, value?: any) => void): void;
+    queryScalar(sql: string, params: QueryParams | null, callback: (err: Error | null, value?: any) => void): void;
+    queryScalar(sql: string, callback: (err: Error | null, value?: any) => void): void;
+
+    /**
+     * Runs a query and writes its result set straight to a file as CSV or NDJSON. Rows are fetched
+     * and serialized on the worker thread and never become JavaScript values.
+     * @param callback Called with the number of rows written.
+     */
+    exportToFile(sql: string, params: QueryParams | null, options: ExportOptions, callback: (err: Error | null, rows?: number) => void): void;
+    exportToFile(sql: string, options: ExportOptions, callback: (err: Error | null, rows?: number) => void): void;
+
     /**
      * Prepares a SQL statement for later execution.
      * @param sql The SQL statement to prepare.
+     * @param options `types` fixes the type each parameter is bound with.
      * @param callback Callback function.
      */
+    prepare(sql: string, options: PrepareOptions, callback: (err: Error | null, stmt?: Statement) => void): void;
     prepare(sql: string, callback: (err: Error | null, stmt?: Statement) => void): void;
 
     /**
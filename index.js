@@ -4,4 +4,67 @@
 
 // 'node-gyp-build' automatically checks the 'prebuilds/' folder (created by prebuildify)
 // and falls back to 'build/Release/' (created by node-gyp rebuild).
-module.exports = require('node-gyp-build')(__dirname)
+const { Readable } = require('stream')
+const binding = require('node-gyp-build')(__dirname)
+
+// Iterating a cursor pulls one batch at a time from the worker thread, so
+// only `fetchSize` rows are held in memory. Rows are yielded one by one,
+// except in columnar mode and the Buffer formats where each batch is yielded
+// as a whole.
+binding.Cursor.prototype[Symbol.asyncIterator] = async function* () {
+  const fetchBatch = () => new Promise((resolve, reject) => {
+    this.fetch((err, batch) => (err ? reject(err) : resolve(batch)))
+  })
+  try {
+    while (!this.done) {
+      const batch = await fetchBatch()
+      if (Array.isArray(batch)) {
+        yield* batch
+      } else if (Array.isArray(batch.rows)) {
+        yield* batch.rows
+      } else if (Buffer.isBuffer(batch)) {
+        yield batch
+      } else if (batch.rowCount > 0) {
+        yield batch
+      }
+    }
+  } finally {
+    if (!this.done) {
+      await new Promise((resolve) => this.close(() => resolve()))
+    }
+  }
+}
+
+// With `lobs: 'stream'`, long columns are returned as Readable streams that
+// pull one chunk at a time from the row the cursor is positioned on. The
+// native Lob calls this when it creates the value of a cell.
+binding.Lob.prototype.stream = function (options) {
+  const lob = this
+  const stream = new Readable({
+    highWaterMark: 64 * 1024,
+    ...options,
+    read (size) {
+      lob.read(size, (err, chunk) => (err ? this.destroy(err) : this.push(chunk)))
+    }
+  })
+  stream.size = lob.size
+  return stream
+}
+
+// A Readable stream or async iterable passed as a parameter is pumped into a
+// native ParamStream, which hands each chunk to the worker executing the
+// statement. write() calls back once the worker has room for more.
+binding.ParamStream.prototype.pump = async function (source) {
+  try {
+    for await (const chunk of source) {
+      await new Promise((resolve, reject) => {
+        this.write(chunk, (err) => (err ? reject(err) : resolve()))
+      })
+    }
+    this.end()
+  } catch (err) {
+    this.fail(err && err.message ? err.message : String(err))
+  }
+}
+
+module.exports = binding
@@ -2,12 +2,35 @@
 const sqlanywhere = require('./index');
 const util = require('util');
 
+// Promisify a cursor returned by exec when the `cursor` option is set
+function promisifyCursor(cursor) {
+  return {
+    fetch: util.promisify(cursor.fetch).bind(cursor),
+    close: util.promisify(cursor.close).bind(cursor),
+    get done() { return cursor.done; },
+    [Symbol.asyncIterator]: () => cursor[Symbol.asyncIterator](),
+  };
+}
+
+// Wrap a callback-style method whose result may be a cursor
+function promisifyResult(obj, method) {
+  const fn = util.promisify(method).bind(obj);
+  return async (...args) => {
+    const result = await fn(...args);
+    return result instanceof sqlanywhere.Cursor ? promisifyCursor(result) : result;
+  };
+}
+
 // Promisify the statement object
 function promisifyStatement(stmt) {
   return {
-    exec: util.promisify(stmt.exec).bind(stmt),
+    exec: promisifyResult(stmt, stmt.exec),
+    queryOne: util.promisify(stmt.queryOne).bind(stmt),
+    queryScalar: util.promisify(stmt.queryScalar).bind(stmt),
+    execBatch: util.promisify(stmt.execBatch).bind(stmt),
+    execBatchColumns: util.promisify(stmt.execBatchColumns).bind(stmt),
     drop: util.promisify(stmt.drop).bind(stmt),
-    getMoreResults: util.promisify(stmt.getMoreResults).bind(stmt),
+    getMoreResults: promisifyResult(stmt, stmt.getMoreResults),
   };
 }
 
@@ -16,15 +39,18 @@ function promisifyConnection(conn) {
   const promisified = {
     connect: util.promisify(conn.connect).bind(conn),
     disconnect: util.promisify(conn.disconnect).bind(conn),
-    exec: util.promisify(conn.exec).bind(conn),
+    exec: promisifyResult(conn, conn.exec),
+    queryOne: util.promisify(conn.queryOne).bind(conn),
+    queryScalar: util.promisify(conn.queryScalar).bind(conn),
+    exportToFile: util.promisify(conn.exportToFile).bind(conn),
     commit: util.promisify(conn.commit).bind(conn),
     rollback: util.promisify(conn.rollback).bind(conn),
     connected: conn.connected.bind(conn), // This is a synchronous method
 
     // We need to wrap prepare to ensure it returns a promisified statement
-    prepare: async (sql) => {
+    prepare: async (sql, options) => {
       const preparePromise = util.promisify(conn.prepare).bind(conn);
-      const stmt = await preparePromise(sql);
+      const stmt = options === undefined ? await preparePromise(sql) : await preparePromise(sql, options);
       return promisifyStatement(stmt);
     },
   };
@@ -34,8 +60,8 @@ function promisifyConnection(conn) {
 }
 
 // Export a new createConnection function that returns a promisified connection
-function createPromisedConnection() {
-    const conn = new sqlanywhere.Connection();
+function createPromisedConnection(defaults) {
+    const conn = new sqlanywhere.Connection(defaults);
     return promisifyConnection(conn);
 }
 
@@ -0,0 +1,334 @@
+#include "h/arrow.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// Enumerations from the Arrow format's Schema.fbs and Message.fbs.
+enum ArrowType : uint8_t {
+    ARROW_NULL = 1, ARROW_INT = 2, ARROW_FLOATING_POINT = 3, ARROW_BINARY = 4, ARROW_UTF8 = 5,
+    ARROW_BOOL = 6, ARROW_DATE = 8, ARROW_TIMESTAMP = 10
+};
+static const int16_t METADATA_V5 = 4;
+static const uint8_t HEADER_SCHEMA = 1;
+static const uint8_t HEADER_RECORD_BATCH = 3;
+static const int16_t PRECISION_SINGLE = 1;
+static const int16_t PRECISION_DOUBLE = 2;
+static const int16_t DATE_UNIT_DAY = 0;
+static const int16_t TIME_UNIT_MICROSECOND = 2;
+
+// A minimal FlatBuffers writer. Objects are written front to back: a table
+// is written with placeholder offsets that are patched once the strings,
+// vectors and tables it refers to have been appended after it.
+class FlatBuilder {
+public:
+    struct Field { uint16_t id; uint8_t size; uint64_t value; };
+    struct Table { size_t at; std::vector<size_t> fields; };
+
+    std::vector<char> buf;
+
+    void pad(size_t align) { buf.resize((buf.size() + align - 1) / align * align, 0); }
+
+    template <typename T> size_t put(T value) {
+        pad(sizeof(T));
+        size_t at = buf.size();
+        buf.resize(at + sizeof(T));
+        memcpy(&buf[at], &value, sizeof(T));
+        return at;
+    }
+
+    // Stores the uoffset at `field` pointing to `target`, which lies after it.
+    void patch(size_t field, size_t target) {
+        uint32_t offset = (uint32_t)(target - field);
+        memcpy(&buf[field], &offset, sizeof(offset));
+    }
+
+    size_t string(const std::string& value) {
+        size_t at = put<uint32_t>((uint32_t)value.size());
+        buf.insert(buf.end(), value.begin(), value.end());
+        buf.push_back(0);
+        return at;
+    }
+
+    // Writes a vector of `count` uoffsets; returns the position of the
+    // length prefix, the first slot follows it.
+    size_t offsetVector(size_t count) {
+        size_t at = put<uint32_t>((uint32_t)count);
+        buf.resize(buf.size() + count * sizeof(uint32_t), 0);
+        return at;
+    }
+
+    // Writes a vector of structs made of int64 pairs (FieldNode, Buffer).
+    size_t pairVector(const std::vector<std::pair<int64_t, int64_t>>& items) {
+        while ((buf.size() + sizeof(uint32_t)) % 8) { buf.push_back(0); }
+        size_t at = put<uint32_t>((uint32_t)items.size());
+        for (const auto& item : items) {
+            put<int64_t>(item.first);
+            put<int64_t>(item.second);
+        }
+        return at;
+    }
+
+    // Writes a vtable followed by its table. Offset fields are written as
+    // zero; `fields` of the result holds each field's position by id.
+    Table table(std::vector<Field> fields) {
+        std::stable_sort(fields.begin(), fields.end(),
+                         [](const Field& a, const Field& b) { return a.size > b.size; });
+        uint16_t slots = 0;
+        size_t align = 4;
+        size_t end = sizeof(int32_t);
+        std::vector<uint16_t> rel;
+        for (const Field& f : fields) {
+            slots = std::max<uint16_t>(slots, f.id + 1);
+            align = std::max<size_t>(align, f.size);
+        }
+        rel.assign(slots, 0);
+        for (const Field& f : fields) {
+            end = (end + f.size - 1) / f.size * f.size;
+            rel[f.id] = (uint16_t)end;
+            end += f.size;
+        }
+
+        size_t vtable = put<uint16_t>((uint16_t)(sizeof(uint16_t) * (2 + slots)));
+        put<uint16_t>((uint16_t)end);
+        for (uint16_t offset : rel) { put<uint16_t>(offset); }
+
+        pad(align);
+        Table table;
+        table.at = put<int32_t>((int32_t)(buf.size() - vtable));
+        table.fields.assign(slots, 0);
+        buf.resize(table.at + end, 0);
+        for (const Field& f : fields) {
+            size_t at = table.at + rel[f.id];
+            memcpy(&buf[at], &f.value, f.size);
+            table.fields[f.id] = at;
+        }
+        return table;
+    }
+};
+
+// Appends one encapsulated IPC message: continuation marker, metadata
+// length, the flatbuffer padded to 8 bytes, then the body.
+static void writeMessage(std::string& out, const FlatBuilder& meta, const std::vector<char>& body) {
+    size_t length = (meta.buf.size() + 7) / 8 * 8;
+    uint32_t prefix[2] = { 0xFFFFFFFFu, (uint32_t)length };
+    out.insert(out.end(), (const char*)prefix, (const char*)prefix + sizeof(prefix));
+    out.insert(out.end(), meta.buf.begin(), meta.buf.end());
+    out.resize(out.size() + length - meta.buf.size(), 0);
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+static FlatBuilder::Table typeTable(FlatBuilder& fb, const ResultColumn& col, uint8_t& type) {
+    switch (col.storage) {
+        case ColumnStorage::Int32:
+            if (col.native_type == DT_BIT) {
+                type = ARROW_BOOL;
+                return fb.table({});
+            }
+            type = ARROW_INT;
+            switch (col.type) {
+                case A_VAL8: return fb.table({ { 0, 4, 8 }, { 1, 1, 1 } });
+                case A_UVAL8: return fb.table({ { 0, 4, 8 }, { 1, 1, 0 } });
+                case A_VAL16: return fb.table({ { 0, 4, 16 }, { 1, 1, 1 } });
+                case A_UVAL16: return fb.table({ { 0, 4, 16 }, { 1, 1, 0 } });
+                default: return fb.table({ { 0, 4, 32 }, { 1, 1, 1 } });
+            }
+        case ColumnStorage::Uint32:
+            type = ARROW_INT;
+            return fb.table({ { 0, 4, 32 }, { 1, 1, 0 } });
+        case ColumnStorage::Int64:
+            type = ARROW_INT;
+            return fb.table({ { 0, 4, 64 }, { 1, 1, 1 } });
+        case ColumnStorage::Uint64:
+            type = ARROW_INT;
+            return fb.table({ { 0, 4, 64 }, { 1, 1, 0 } });
+        case ColumnStorage::Double:
+            type = ARROW_FLOATING_POINT;
+            return fb.table({ { 0, 2, (uint64_t)(col.type == A_FLOAT ? PRECISION_SINGLE : PRECISION_DOUBLE) } });
+        case ColumnStorage::String:
+            type = ARROW_UTF8;
+            return fb.table({});
+        case ColumnStorage::Binary:
+            type = ARROW_BINARY;
+            return fb.table({});
+        case ColumnStorage::Timestamp:
+            if (col.native_type == DT_DATE) {
+                type = ARROW_DATE;
+                return fb.table({ { 0, 2, (uint64_t)DATE_UNIT_DAY } });
+            } else {
+                type = ARROW_TIMESTAMP;
+                // No timezone: the server's TIMESTAMP is a wall-clock value.
+                return fb.table({ { 0, 2, (uint64_t)TIME_UNIT_MICROSECOND } });
+            }
+        default:
+            type = ARROW_NULL;
+            return fb.table({});
+    }
+}
+
+static void writeSchema(std::string& out, const std::vector<ResultColumn>& columns) {
+    FlatBuilder fb;
+    size_t root = fb.put<uint32_t>(0);
+    FlatBuilder::Table message = fb.table({ { 0, 2, (uint64_t)METADATA_V5 }, { 1, 1, HEADER_SCHEMA }, { 2, 4, 0 }, { 3, 8, 0 } });
+    fb.patch(root, message.at);
+    FlatBuilder::Table schema = fb.table({ { 0, 2, 0 }, { 1, 4, 0 } });
+    fb.patch(message.fields[2], schema.at);
+    size_t list = fb.offsetVector(columns.size());
+    fb.patch(schema.fields[1], list);
+    for (size_t i = 0; i < columns.size(); i++) {
+        const ResultColumn& col = columns[i];
+        // The type_type value is only known once the type table is chosen,
+        // so it is patched in afterwards.
+        FlatBuilder::Table field = fb.table({ { 0, 4, 0 }, { 1, 1, 1 }, { 2, 1, 0 }, { 3, 4, 0 }, { 5, 4, 0 } });
+        fb.patch(list + 4 + 4 * i, field.at);
+        fb.patch(field.fields[0], fb.string(col.name));
+        uint8_t type = ARROW_NULL;
+        FlatBuilder::Table type_table = typeTable(fb, col, type);
+        fb.buf[field.fields[2]] = (char)type;
+        fb.patch(field.fields[3], type_table.at);
+        fb.patch(field.fields[5], fb.offsetVector(0));
+    }
+    writeMessage(out, fb, std::vector<char>());
+}
+
+// Collects the body of a record batch, each buffer padded to 8 bytes.
+struct BatchBody {
+    std::vector<char> data;
+    std::vector<std::pair<int64_t, int64_t>> buffers;
+    std::vector<std::pair<int64_t, int64_t>> nodes;
+
+    void add(const void* bytes, size_t length) {
+        size_t at = data.size();
+        data.insert(data.end(), (const char*)bytes, (const char*)bytes + length);
+        data.resize((data.size() + 7) / 8 * 8, 0);
+        buffers.push_back({ (int64_t)at, (int64_t)length });
+    }
+
+    template <typename T> void addValues(const std::vector<T>& values) {
+        add(values.data(), values.size() * sizeof(T));
+    }
+};
+
+// Arrow validity bitmaps set a bit for each valid value; ours mark nulls.
+// DATE / TIMESTAMP values that could not be parsed are sent as nulls too.
+static bool isValid(const ResultColumn& col, size_t r) {
+    if (col.isNull(r)) {
+        return false;
+    }
+    return col.storage != ColumnStorage::Timestamp || col.fixedAt<int64_t>(r) != ARROW_INVALID_TIMESTAMP;
+}
+
+static size_t addValidity(BatchBody& body, const ResultColumn& col, size_t rows) {
+    size_t null_count = 0;
+    std::vector<uint8_t> valid((rows + 7) / 8, 0);
+    for (size_t r = 0; r < rows; r++) {
+        if (isValid(col, r)) { valid[r >> 3] |= (uint8_t)(1 << (r & 7)); }
+        else { null_count++; }
+    }
+    if (null_count == 0) { body.add(nullptr, 0); }
+    else { body.addValues(valid); }
+    return null_count;
+}
+
+template <typename To, typename From>
+static void addNarrowed(BatchBody& body, const ResultColumn& col, size_t rows) {
+    std::vector<To> values(rows);
+    for (size_t r = 0; r < rows; r++) { values[r] = (To)col.fixedAt<From>(r); }
+    body.addValues(values);
+}
+
+static bool addColumn(BatchBody& body, const ResultColumn& col, size_t rows, std::string& error_msg) {
+    if (col.storage == ColumnStorage::Lob || col.storage == ColumnStorage::Unsupported) {
+        // Null arrays have no buffers at all.
+        body.nodes.push_back({ (int64_t)rows, (int64_t)rows });
+        return true;
+    }
+    size_t null_count = addValidity(body, col, rows);
+    body.nodes.push_back({ (int64_t)rows, (int64_t)null_count });
+    switch (col.storage) {
+        case ColumnStorage::Int32:
+            if (col.native_type == DT_BIT) {
+                std::vector<uint8_t> bits((rows + 7) / 8, 0);
+                for (size_t r = 0; r < rows; r++) {
+                    if (col.fixedAt<int32_t>(r)) { bits[r >> 3] |= (uint8_t)(1 << (r & 7)); }
+                }
+                body.addValues(bits);
+            } else if (col.type == A_VAL8 || col.type == A_UVAL8) {
+                addNarrowed<int8_t, int32_t>(body, col, rows);
+            } else if (col.type == A_VAL16 || col.type == A_UVAL16) {
+                addNarrowed<int16_t, int32_t>(body, col, rows);
+            } else {
+                body.addValues(col.fixed);
+            }
+            break;
+        case ColumnStorage::Double:
+            if (col.type == A_FLOAT) { addNarrowed<float, double>(body, col, rows); }
+            else { body.addValues(col.fixed); }
+            break;
+        case ColumnStorage::Timestamp: {
+            if (col.native_type == DT_DATE) {
+                std::vector<int32_t> days(rows, 0);
+                for (size_t r = 0; r < rows; r++) {
+                    int64_t micros = col.fixedAt<int64_t>(r);
+                    if (micros != ARROW_INVALID_TIMESTAMP) {
+                        days[r] = (int32_t)((micros - (micros < 0 ? 86399999999LL : 0)) / 86400000000LL);
+                    }
+                }
+                body.addValues(days);
+            } else {
+                std::vector<int64_t> micros(rows, 0);
+                for (size_t r = 0; r < rows; r++) {
+                    int64_t value = col.fixedAt<int64_t>(r);
+                    if (value != ARROW_INVALID_TIMESTAMP) { micros[r] = value; }
+                }
+                body.addValues(micros);
+            }
+            break;
+        }
+        case ColumnStorage::String:
+        case ColumnStorage::Binary:
+            if (col.data.size() > (size_t)std::numeric_limits<int32_t>::max()) {
+                error_msg = "Result set is too large to be encoded as a single Arrow record batch.";
+                return false;
+            }
+            body.addValues(col.offsets);
+            body.addValues(col.data);
+            break;
+        default:
+            body.addValues(col.fixed);
+            break;
+    }
+    return true;
+}
+
+static bool writeRecordBatch(std::string& out, const std::vector<ResultColumn>& columns, size_t rows,
+                             std::string& error_msg) {
+    BatchBody body;
+    for (const ResultColumn& col : columns) {
+        if (!addColumn(body, col, rows, error_msg)) {
+            return false;
+        }
+    }
+    FlatBuilder fb;
+    size_t root = fb.put<uint32_t>(0);
+    FlatBuilder::Table message = fb.table({ { 0, 2, (uint64_t)METADATA_V5 }, { 1, 1, HEADER_RECORD_BATCH },
+                                            { 2, 4, 0 }, { 3, 8, (uint64_t)body.data.size() } });
+    fb.patch(root, message.at);
+    FlatBuilder::Table batch = fb.table({ { 0, 8, (uint64_t)rows }, { 1, 4, 0 }, { 2, 4, 0 } });
+    fb.patch(message.fields[2], batch.at);
+    fb.patch(batch.fields[1], fb.pairVector(body.nodes));
+    fb.patch(batch.fields[2], fb.pairVector(body.buffers));
+    writeMessage(out, fb, body.data);
+    return true;
+}
+
+bool writeArrowStream(const std::vector<ResultColumn>& columns, size_t row_count,
+                      std::string& out, std::string& error_msg) {
+    writeSchema(out, columns);
+    if (!writeRecordBatch(out, columns, row_count, error_msg)) {
+        return false;
+    }
+    uint32_t end_of_stream[2] = { 0xFFFFFFFFu, 0 };
+    out.insert(out.end(), (const char*)end_of_stream, (const char*)end_of_stream + sizeof(end_of_stream));
+    return true;
+}
@@ -1,191 +1,297 @@
 #include "h/async_workers.h"
 #include <cmath>
+#include <algorithm>
 
 // Forward declaration to be used in prepareBindParams
 void prepareBindParams(Napi::Array params, std::vector<a_sqlany_bind_param>& bind_params, ExecuteData& param_data);
 
-Napi::Value buildResult(Napi::Env env, a_sqlany_stmt* stmt) {
-    int num_cols = api.sqlany_num_cols(stmt);
-    if (num_cols <= 0) {
-        return Napi::Number::New(env, api.sqlany_affected_rows(stmt));
-    }
-    Napi::Array results = Napi::Array::New(env);
-    uint32_t row_num = 0;
-    while (api.sqlany_fetch_next(stmt)) {
-        Napi::Object row = Napi::Object::New(env);
-        for (int i = 0; i < num_cols; i++) {
-            a_sqlany_column_info info;
-            api.sqlany_get_column_info(stmt, i, &info);
-            a_sqlany_data_value val;
-            api.sqlany_get_column(stmt, i, &val);
-            if (*val.is_null) {
-                row.Set(info.name, env.Null());
+// Encodes a JavaScript string as UTF-8 straight into the arena: the length
+// is measured first so that the bytes are copied only once.
+static char* addUtf8(const Napi::String& str, ExecuteData& param_data, size_t& length) {
+    napi_get_value_string_utf8(str.Env(), str, nullptr, 0, &length);
+    char* buf = static_cast<char*>(param_data.allocate(length + 1, 1));
+    napi_get_value_string_utf8(str.Env(), str, buf, length + 1, &length);
+    return buf;
+}
+
+// --- Helper: Prepare C++ bind parameters (shared logic) ---
+// Values, lengths and string bytes are written into param_data's arena, so
+// binding a statement's parameters needs no per-value heap allocation.
+// Buffers are not copied: the bind points at their memory, and param_data
+// keeps them referenced until the request completes. Streams and async
+// iterables are bound without a value; their chunks are sent by
+// param_data.streams once the statement is bound.
+void bindParamValue(const Napi::Value& val, uint32_t index, a_sqlany_bind_param& p, ExecuteData& param_data) {
+    if (ParamStream::IsSource(val)) {
+        param_data.streams.add(index, ParamStream::New(val));
+        p.value.type = A_BINARY;
+    } else if (val.IsBuffer()) {
+        Napi::Buffer<char> buffer = val.As<Napi::Buffer<char>>();
+        if (buffer.Length() > 0) {
+            param_data.pin(buffer);
+            p.value.buffer = buffer.Data();
+        } else {
+            p.value.buffer = param_data.addBytes("", 0);
+        }
+        p.value.type = A_BINARY;
+        p.value.length = param_data.add<size_t>(buffer.Length());
+    } else if (val.IsString()) {
+        size_t length = 0;
+        p.value.buffer = addUtf8(val.As<Napi::String>(), param_data, length);
+        p.value.type = A_STRING;
+        p.value.length = param_data.add<size_t>(length);
+    } else if (val.IsNumber()) {
+        double num_val = val.ToNumber().DoubleValue();
+        if (floor(num_val) == num_val && num_val < 9007199254740991.0 && num_val > -9007199254740991.0) { // Is a safe integer
+            if (num_val >= -2147483648 && num_val <= 2147483647) {
+                p.value.buffer = (char*)param_data.add<int>((int)num_val);
+                p.value.type = A_VAL32;
             } else {
-                switch(val.type) {
-                    case A_BINARY:
-                        row.Set(info.name, Napi::Buffer<char>::Copy(env, val.buffer, *val.length));
-                        break;
-                    case A_STRING: 
-                        row.Set(info.name, Napi::String::New(env, val.buffer, *val.length)); 
-                        break;
-                    case A_DOUBLE: 
-                        row.Set(info.name, Napi::Number::New(env, *(double*)val.buffer)); 
-                        break;
-                    case A_FLOAT:
-                        row.Set(info.name, Napi::Number::New(env, *(float*)val.buffer)); 
-                        break;
-                    case A_VAL64: 
-                        row.Set(info.name, Napi::Number::New(env, (double)(*(long long*)val.buffer))); 
-                        break;
-                    case A_UVAL64: 
-                        row.Set(info.name, Napi::Number::New(env, (double)(*(unsigned long long*)val.buffer))); 
-                        break;
-                    case A_VAL32: 
-                        row.Set(info.name, Napi::Number::New(env, *(int*)val.buffer)); 
-                        break;
-                    case A_UVAL32: 
-                        row.Set(info.name, Napi::Number::New(env, *(unsigned int*)val.buffer)); 
-                        break;
-                    case A_VAL16: 
-                        row.Set(info.name, Napi::Number::New(env, *(short*)val.buffer)); 
-                        break;
-                    case A_UVAL16: 
-                        row.Set(info.name, Napi::Number::New(env, *(unsigned short*)val.buffer)); 
-                        break;
-                    case A_VAL8: 
-                        row.Set(info.name, Napi::Number::New(env, *(signed char*)val.buffer)); 
-                        break;
-                    case A_UVAL8: 
-                        row.Set(info.name, Napi::Number::New(env, *(unsigned char*)val.buffer)); 
-                        break;
-                    default: 
-                        row.Set(info.name, Napi::String::New(env, "Unsupported Type"));
-                }
+                p.value.buffer = (char*)param_data.add<long long>((long long)num_val);
+                p.value.type = A_VAL64;
+            }
+        } else {
+            p.value.buffer = (char*)param_data.add<double>(num_val);
+            p.value.type = A_DOUBLE;
+        }
+    } else if (val.IsBigInt()) {
+        // Bound exactly as 64-bit integers; values outside both ranges are
+        // sent as decimal strings and converted by the server.
+        Napi::BigInt big = val.As<Napi::BigInt>();
+        bool lossless = false;
+        long long ll = big.Int64Value(&lossless);
+        if (lossless) {
+            p.value.buffer = (char*)param_data.add<long long>(ll);
+            p.value.type = A_VAL64;
+        } else {
+            unsigned long long ull = big.Uint64Value(&lossless);
+            if (lossless) {
+                p.value.buffer = (char*)param_data.add<unsigned long long>(ull);
+                p.value.type = A_UVAL64;
+            } else {
+                size_t length = 0;
+                p.value.buffer = addUtf8(val.ToString(), param_data, length);
+                p.value.type = A_STRING;
+                p.value.length = param_data.add<size_t>(length);
             }
         }
-        results[row_num++] = row;
+    } else if (val.IsNull() || val.IsUndefined()) {
+         p.value.buffer = NULL;
+         p.value.length = NULL; 
+         p.value.type = A_INVALID_TYPE;
     }
-    return results;
 }
 
-// --- Helper: Prepare C++ bind parameters (shared logic) ---
 void prepareBindParams(Napi::Array params, std::vector<a_sqlany_bind_param>& bind_params, ExecuteData& param_data) {
+    bind_params.reserve(bind_params.size() + params.Length());
     for (uint32_t i = 0; i < params.Length(); i++) {
         a_sqlany_bind_param p;
         memset(&p, 0, sizeof(p));
         p.direction = DD_INPUT;
-        Napi::Value val = params.Get(i);
-
-        if (val.IsBuffer()) {
-            Napi::Buffer<char> buffer = val.As<Napi::Buffer<char>>();
-            size_t* len = new size_t(buffer.Length());
-            char* buf = new char[*len];
-            memcpy(buf, buffer.Data(), *len);
-            
-            p.value.buffer = buf;
-            p.value.type = A_BINARY;
-            p.value.length = len;
-            param_data.addString(buf, len);
-        } else if (val.IsString()) {
-            std::string str = val.ToString().Utf8Value();
-            size_t* len = new size_t(str.length());
-            char* buf = new char[*len + 1];
-            memcpy(buf, str.c_str(), *len + 1);
-            
-            p.value.buffer = buf;
-            p.value.type = A_STRING;
-            p.value.length = len;
-            param_data.addString(buf, len);
-        } else if (val.IsNumber()) {
-            double num_val = val.ToNumber().DoubleValue();
-            if (floor(num_val) == num_val && num_val < 9007199254740991.0 && num_val > -9007199254740991.0) { // Is a safe integer
-                if (num_val >= -2147483648 && num_val <= 2147483647) {
-                    int* int_val = new int((int)num_val);
-                    p.value.buffer = (char*)int_val;
-                    p.value.type = A_VAL32;
-                    param_data.addInt(int_val);
-                } else {
-                    long long* ll_val = new long long((long long)num_val);
-                    p.value.buffer = (char*)ll_val;
-                    p.value.type = A_VAL64;
-                    param_data.addLongLong(ll_val);
-                }
-            } else {
-                double* dbl_val = new double(num_val);
-                p.value.buffer = (char*)dbl_val;
-                p.value.type = A_DOUBLE;
-                param_data.addDouble(dbl_val);
-            }
-        } else if (val.IsNull() || val.IsUndefined()) {
-             p.value.buffer = NULL;
-             p.value.length = NULL; 
-             p.value.type = A_INVALID_TYPE;
-        }
-
+        bindParamValue(params.Get(i), i, p, param_data);
         bind_params.push_back(p);
     }
 }
 
 
-ExecWorker::ExecWorker(Connection* c, const Napi::Function& cb, std::string s, Napi::Array p)
-    : Napi::AsyncWorker(cb), conn_obj(c), sql(s), result(Env().Undefined()), error_msg("") {
+// Runs `sql` directly, or prepares it and binds `bind_params` (sending any
+// stream parameters) when there are any. Returns the executed statement for
+// the caller to free, or NULL with error_msg set. Must be called with
+// conn_mutex held.
+static a_sqlany_stmt* executeSql(a_sqlany_connection* conn, const std::string& sql,
+                                 std::vector<a_sqlany_bind_param>& bind_params, StreamParams& streams,
+                                 std::string& error_msg) {
+    if (bind_params.empty()) {
+        a_sqlany_stmt* stmt = api.sqlany_execute_direct(conn, sql.c_str());
+        if (!stmt) { getErrorMsg(conn, error_msg); }
+        return stmt;
+    }
+    a_sqlany_stmt* stmt = api.sqlany_prepare(conn, sql.c_str());
+    if (!stmt) {
+        getErrorMsg(conn, error_msg);
+        return nullptr;
+    }
+    for (size_t i = 0; i < bind_params.size(); i++) {
+        if (!api.sqlany_bind_param(stmt, i, &bind_params[i])) {
+            getErrorMsg(conn, error_msg);
+            api.sqlany_free_stmt(stmt);
+            return nullptr;
+        }
+    }
+    if (!streams.empty() && !streams.send(stmt, conn, error_msg)) {
+        api.sqlany_free_stmt(stmt);
+        return nullptr;
+    }
+    if (!api.sqlany_execute(stmt)) {
+        getErrorMsg(conn, error_msg);
+        api.sqlany_free_stmt(stmt);
+        return nullptr;
+    }
+    return stmt;
+}
+
+ExecWorker::ExecWorker(Connection* c, const Napi::Function& cb, std::string s, Napi::Array p, const QueryOptions& o)
+    : ConnectionWorker(c, cb), conn_obj(c), sql(s), options(o), error_msg("") {
     prepareBindParams(p, bind_params, param_data);
 }
 void ExecWorker::Execute() {
     uv_mutex_lock(&conn_obj->conn_mutex);
-    if (bind_params.empty()) {
-        stmt_handle = api.sqlany_execute_direct(conn_obj->conn, sql.c_str());
-    } else {
-        stmt_handle = api.sqlany_prepare(conn_obj->conn, sql.c_str());
-        if(stmt_handle) {
-            for (size_t i = 0; i < bind_params.size(); i++) {
-                if (!api.sqlany_bind_param(stmt_handle, i, &bind_params[i])) {
-                    getErrorMsg(conn_obj->conn, error_msg);
-                    break;
-                }
-            }
-            if(error_msg.empty() && !api.sqlany_execute(stmt_handle)) {
-                getErrorMsg(conn_obj->conn, error_msg);
-            }
+    a_sqlany_stmt* stmt_handle = executeSql(conn_obj->conn, sql, bind_params, param_data.streams, error_msg);
+    if (stmt_handle) {
+        if (!options.cursor) {
+            results.fetch(stmt_handle, conn_obj->conn, error_msg, options);
+        } else if (results.describe(stmt_handle, conn_obj->conn, error_msg, options) && results.hasColumns()) {
+            // The cursor takes over the statement and frees it once drained,
+            // or the connection does when it is closed first.
+            cursor_state = std::make_shared<CursorState>();
+            cursor_state->owned_stmt = stmt_handle;
+            conn_obj->cursor_states.push_back(cursor_state);
+            stmt_handle = nullptr;
         }
     }
-    if (!stmt_handle && error_msg.empty()) {
-        getErrorMsg(conn_obj->conn, error_msg);
+    if (stmt_handle) {
+        api.sqlany_free_stmt(stmt_handle);
     }
     uv_mutex_unlock(&conn_obj->conn_mutex);
 }
 void ExecWorker::OnOK() {
     Napi::HandleScope scope(Env());
+    if (!error_msg.empty()) { Callback().Call({Napi::Error::New(Env(), error_msg).Value()}); }
+    else if (cursor_state) {
+        Napi::Object cursor = Cursor::constructor.New({});
+        Cursor::Unwrap(cursor)->open(conn_obj, cursor_state, results, options);
+        Callback().Call({Env().Null(), cursor});
+    }
+    else { Callback().Call({Env().Null(), results.toJS(Env(), options)}); }
+}
+
+
+// Rows fetched per batch, and bytes of text collected before each write.
+static const size_t EXPORT_BATCH_ROWS = 4096;
+static const size_t EXPORT_CHUNK_BYTES = 1 << 20;
+
+ExportWorker::ExportWorker(Connection* c, const Napi::Function& cb, std::string s, Napi::Array p, const ExportOptions& o)
+    : ConnectionWorker(c, cb), conn_obj(c), sql(s), options(o), error_msg("") {
+    prepareBindParams(p, bind_params, param_data);
+}
+void ExportWorker::Execute() {
+    uv_mutex_lock(&conn_obj->conn_mutex);
+    a_sqlany_stmt* stmt_handle = executeSql(conn_obj->conn, sql, bind_params, param_data.streams, error_msg);
     if (stmt_handle) {
-        if(error_msg.empty()) { result = buildResult(Env(), stmt_handle); }
+        writeRows(stmt_handle);
         api.sqlany_free_stmt(stmt_handle);
     }
+    uv_mutex_unlock(&conn_obj->conn_mutex);
+}
+// Fetches the result set in batches and appends each batch's text to the
+// file; only one batch and about one chunk of text are held at a time.
+bool ExportWorker::writeRows(a_sqlany_stmt* stmt) {
+    ResultSet layout;
+    if (!layout.describe(stmt, conn_obj->conn, error_msg, QueryOptions())) {
+        return false;
+    }
+    if (!layout.hasColumns()) {
+        error_msg = "exportToFile requires a statement that returns a result set.";
+        return false;
+    }
+    FileSink file;
+    if (!file.open(options.path, error_msg)) {
+        return false;
+    }
+    std::string text;
+    text.reserve(EXPORT_CHUNK_BYTES);
+    if (options.format == TextFormat::Csv && options.header) {
+        appendCsvHeader(text, layout.columnData());
+    }
+    bool exhausted = false;
+    while (!exhausted) {
+        ResultSet batch(layout);
+        if (!batch.fetchRows(stmt, conn_obj->conn, EXPORT_BATCH_ROWS, error_msg)) {
+            return false;
+        }
+        if (options.format == TextFormat::Csv) {
+            appendCsvRows(text, batch.columnData(), batch.rowCount());
+        } else {
+            appendJsonRows(text, batch.columnData(), batch.rowCount(), '\n');
+        }
+        rows_written += batch.rowCount();
+        exhausted = batch.isExhausted();
+        if ((exhausted || text.size() >= EXPORT_CHUNK_BYTES) && !file.write(text, error_msg)) {
+            return false;
+        }
+    }
+    return file.close(error_msg);
+}
+void ExportWorker::OnOK() {
+    Napi::HandleScope scope(Env());
     if (!error_msg.empty()) { Callback().Call({Napi::Error::New(Env(), error_msg).Value()}); }
-    else { Callback().Call({Env().Null(), result}); }
+    else { Callback().Call({Env().Null(), Napi::Number::New(Env(), (double)rows_written)}); }
 }
 
 
-ExecStmtWorker::ExecStmtWorker(StmtObject* s, const Napi::Function& cb, Napi::Array p)
-    : Napi::AsyncWorker(cb), stmt_obj(s), result(Env().Undefined()), error_msg("") {
-    prepareBindParams(p, bind_params, param_data);
+ExecStmtWorker::ExecStmtWorker(StmtObject* s, const Napi::Function& cb, Napi::Array p, const QueryOptions& o)
+    : ConnectionWorker(s->connection, cb), stmt_obj(s), options(o), error_msg("") {
+    if (s->params.fits(p)) {
+        // A value that does not match the statement's type signature fails
+        // the call without executing it.
+        s->params.stage(p, param_data, staged, error_msg);
+        use_staged = true;
+    } else {
+        prepareBindParams(p, bind_params, param_data);
+    }
 }
 void ExecStmtWorker::Execute() {
+    if (!error_msg.empty()) {
+        return;
+    }
     uv_mutex_lock(&stmt_obj->connection->conn_mutex);
-    for (size_t i = 0; i < bind_params.size(); i++) {
-        if (!api.sqlany_bind_param(stmt_obj->sqlany_stmt, i, &bind_params[i])) {
+    generation = ++stmt_obj->generation;
+    if (use_staged) {
+        if (!stmt_obj->params.apply(stmt_obj->sqlany_stmt, staged)) {
             getErrorMsg(stmt_obj->connection->conn, error_msg);
-            break;
         }
+    } else {
+        stmt_obj->params.invalidate();
+        for (size_t i = 0; i < bind_params.size(); i++) {
+            if (!api.sqlany_bind_param(stmt_obj->sqlany_stmt, i, &bind_params[i])) {
+                getErrorMsg(stmt_obj->connection->conn, error_msg);
+                break;
+            }
+        }
+    }
+    if (error_msg.empty() && !param_data.streams.empty()) {
+        param_data.streams.send(stmt_obj->sqlany_stmt, stmt_obj->connection->conn, error_msg);
     }
     if(error_msg.empty() && !api.sqlany_execute(stmt_obj->sqlany_stmt)) {
         getErrorMsg(stmt_obj->connection->conn, error_msg);
     }
+    if (error_msg.empty()) {
+        if (options.cursor) { results.describe(stmt_obj->sqlany_stmt, stmt_obj->connection->conn, error_msg, options); }
+        else { results.fetch(stmt_obj->sqlany_stmt, stmt_obj->connection->conn, error_msg, options); }
+    }
     uv_mutex_unlock(&stmt_obj->connection->conn_mutex);
 }
+
+// Wraps the current result set of a prepared statement in a Cursor, or falls
+// back to the plain result for statements without a result set.
+static Napi::Value borrowingCursor(Napi::Env env, StmtObject* stmt_obj, unsigned int generation,
+                                   ResultSet& results, const QueryOptions& options) {
+    if (!results.hasColumns()) {
+        return results.toJS(env, options);
+    }
+    Napi::Object cursor = Cursor::constructor.New({});
+    Cursor::Unwrap(cursor)->open(stmt_obj, generation, results, options);
+    return cursor;
+}
+
 void ExecStmtWorker::OnOK() {
     Napi::HandleScope scope(Env());
+    if (error_msg.empty() && options.cursor && !stmt_obj->connection) {
+        error_msg = "Statement was dropped before the cursor could be opened.";
+    }
     if (error_msg.empty()) {
-        result = buildResult(Env(), stmt_obj->sqlany_stmt);
+        Napi::Value result = options.cursor ? borrowingCursor(Env(), stmt_obj, generation, results, options)
+                                            : results.toJS(Env(), options);
         Callback().Call({Env().Null(), result});
     } else {
         Callback().Call({Napi::Error::New(Env(), error_msg).Value()});
@@ -193,8 +299,25 @@ void ExecStmtWorker::OnOK() {
 }
 
 
+ExecBatchWorker::ExecBatchWorker(StmtObject* s, const Napi::Function& cb, BatchParams&& p)
+    : ConnectionWorker(s->connection, cb), stmt_obj(s), params(std::move(p)), error_msg("") {}
+void ExecBatchWorker::Execute() {
+    uv_mutex_lock(&stmt_obj->connection->conn_mutex);
+    // Executing discards the statement's current result set.
+    ++stmt_obj->generation;
+    stmt_obj->params.invalidate();
+    params.execute(stmt_obj->sqlany_stmt, stmt_obj->connection->conn, affected_rows, error_msg);
+    uv_mutex_unlock(&stmt_obj->connection->conn_mutex);
+}
+void ExecBatchWorker::OnOK() {
+    Napi::HandleScope scope(Env());
+    if (!error_msg.empty()) { Callback().Call({Napi::Error::New(Env(), error_msg).Value()}); }
+    else { Callback().Call({Env().Null(), Napi::Number::New(Env(), (double)affected_rows)}); }
+}
+
+
 ConnectWorker::ConnectWorker(Connection* c, const Napi::Function& cb, std::string s)
-    : Napi::AsyncWorker(cb), conn_obj(c), conn_str(s), error_msg("") {}
+    : ConnectionWorker(c, cb), conn_obj(c), conn_str(s), error_msg("") {}
 void ConnectWorker::Execute() {
     uv_mutex_lock(&conn_obj->conn_mutex);
     if (conn_obj->conn) { error_msg = "Connection already exists."; }
@@ -215,7 +338,7 @@ void ConnectWorker::OnOK() {
 }
 
 NoParamsWorker::NoParamsWorker(Connection* c, const Napi::Function& cb, Task t)
-    : Napi::AsyncWorker(cb), conn_obj(c), task(t), error_msg("") {}
+    : ConnectionWorker(c, cb), conn_obj(c), task(t), error_msg("") {}
 void NoParamsWorker::Execute() {
     uv_mutex_lock(&conn_obj->conn_mutex);
     if (!conn_obj->conn && task != Task::Disconnect) { error_msg = "Not connected."; }
@@ -241,16 +364,22 @@ void NoParamsWorker::Execute() {
 }
 void NoParamsWorker::OnOK() {
     Napi::HandleScope scope(Env());
+    if (task == Task::Disconnect) { conn_obj->detachCursors(); }
     if (!error_msg.empty()) { Callback().Call({Napi::Error::New(Env(), error_msg).Value()}); }
     else { Callback().Call({Env().Null()}); }
 }
 
-PrepareWorker::PrepareWorker(Connection* c, const Napi::Function& cb, std::string s)
-    : Napi::AsyncWorker(cb), conn_obj(c), sql(s), error_msg("") {}
+PrepareWorker::PrepareWorker(Connection* c, const Napi::Function& cb, std::string s,
+                             std::vector<a_sqlany_data_type> t)
+    : ConnectionWorker(c, cb), conn_obj(c), sql(s), types(std::move(t)), error_msg("") {}
 void PrepareWorker::Execute() {
     uv_mutex_lock(&conn_obj->conn_mutex);
     stmt_handle = api.sqlany_prepare(conn_obj->conn, sql.c_str());
     if (!stmt_handle) { getErrorMsg(conn_obj->conn, error_msg); }
+    else if (!params.describe(stmt_handle, types, error_msg)) {
+        api.sqlany_free_stmt(stmt_handle);
+        stmt_handle = nullptr;
+    }
     uv_mutex_unlock(&conn_obj->conn_mutex);
 }
 void PrepareWorker::OnOK() {
@@ -259,6 +388,7 @@ void PrepareWorker::OnOK() {
         Napi::Object stmt_obj = StmtObject::constructor.New({});
         StmtObject* unwrapped = Napi::ObjectWrap<StmtObject>::Unwrap(stmt_obj);
         unwrapped->sqlany_stmt = stmt_handle;
+        unwrapped->params = std::move(params);
         unwrapped->setConnection(conn_obj);
         Callback().Call({Env().Null(), stmt_obj});
     } else {
@@ -267,7 +397,7 @@ void PrepareWorker::OnOK() {
 }
 
 DropStmtWorker::DropStmtWorker(StmtObject* s, const Napi::Function& cb)
-    : Napi::AsyncWorker(cb), stmt_obj(s) {}
+    : ConnectionWorker(s->connection, cb), stmt_obj(s) {}
 void DropStmtWorker::Execute() {
     stmt_obj->cleanup();
 }
@@ -275,8 +405,8 @@ void DropStmtWorker::OnOK() {
     Callback().Call({Env().Null()});
 }
 
-GetMoreResultsWorker::GetMoreResultsWorker(StmtObject* s, const Napi::Function& cb)
-    : Napi::AsyncWorker(cb), stmt_obj(s), result(Env().Undefined()), error_msg(""), has_more_results(false) {}
+GetMoreResultsWorker::GetMoreResultsWorker(StmtObject* s, const Napi::Function& cb, const QueryOptions& o)
+    : ConnectionWorker(s->connection, cb), stmt_obj(s), options(o), error_msg(""), has_more_results(false) {}
 void GetMoreResultsWorker::Execute() {
     uv_mutex_lock(&stmt_obj->connection->conn_mutex);
     if (!stmt_obj || !stmt_obj->sqlany_stmt) {
@@ -284,6 +414,7 @@ void GetMoreResultsWorker::Execute() {
         uv_mutex_unlock(&stmt_obj->connection->conn_mutex);
         return;
     }
+    generation = ++stmt_obj->generation;
     has_more_results = api.sqlany_get_next_result(stmt_obj->sqlany_stmt);
     if (!has_more_results) {
         char buffer[SACAPI_ERROR_SIZE];
@@ -291,6 +422,10 @@ void GetMoreResultsWorker::Execute() {
         if (rc != 0 && rc != 100) {
             error_msg = buffer;
         }
+    } else if (options.cursor) {
+        results.describe(stmt_obj->sqlany_stmt, stmt_obj->connection->conn, error_msg, options);
+    } else {
+        results.fetch(stmt_obj->sqlany_stmt, stmt_obj->connection->conn, error_msg, options);
     }
     uv_mutex_unlock(&stmt_obj->connection->conn_mutex);
 }
@@ -298,10 +433,90 @@ void GetMoreResultsWorker::OnOK() {
     Napi::HandleScope scope(Env());
     if (!error_msg.empty()) {
         Callback().Call({Napi::Error::New(Env(), error_msg).Value()});
+    } else if (has_more_results && options.cursor && !stmt_obj->connection) {
+        Callback().Call({Napi::Error::New(Env(), "Statement was dropped before the cursor could be opened.").Value()});
     } else if (has_more_results) {
-        result = buildResult(Env(), stmt_obj->sqlany_stmt);
+        Napi::Value result = options.cursor ? borrowingCursor(Env(), stmt_obj, generation, results, options)
+                                            : results.toJS(Env(), options);
         Callback().Call({Env().Null(), result});
     } else {
         Callback().Call({Env().Null(), Env().Undefined()});
     }
-}
\ No newline at end of file
+}
+
+CursorFetchWorker::CursorFetchWorker(Cursor* c, const Napi::Function& cb, uint32_t n)
+    : ConnectionWorker(c->connection, c->Value(), cb), cursor(c), conn_obj(c->connection), state(c->state),
+      max_rows(n), results(c->layout), error_msg("") {}
+void CursorFetchWorker::Execute() {
+    // A detached cursor has no connection left to fetch from.
+    if (!conn_obj || !state) { return; }
+    uv_mutex_lock(&conn_obj->conn_mutex);
+    // Re-check: a disconnect may have closed the cursor while we waited.
+    if (!state->closed) {
+        size_t limit = max_rows;
+        if (cursor->options.max_rows) {
+            limit = (size_t)std::min<uint64_t>(limit, cursor->options.max_rows - state->rows_fetched);
+        }
+        a_sqlany_stmt* stmt = state->statement(error_msg);
+        // Once maxRows rows have been handed out, the next fetch returns an
+        // empty batch and closes the cursor without reading further.
+        if (!stmt || limit == 0) {
+            conn_obj->closeCursor(state.get());
+        } else if (!results.fetchRows(stmt, conn_obj->conn, limit, error_msg) || results.isExhausted()) {
+            conn_obj->closeCursor(state.get());
+        }
+        state->rows_fetched += results.rowCount();
+        // Every row, and every fetch past the end, moves the cursor on; a Lob
+        // stays readable only while the cursor is still at its row.
+        results.first_position = state->position + 1;
+        state->position += std::max<size_t>(results.rowCount(), 1);
+    }
+    open = !state->closed;
+    uv_mutex_unlock(&conn_obj->conn_mutex);
+}
+void CursorFetchWorker::OnOK() {
+    Napi::HandleScope scope(Env());
+    if (!open) { cursor->detach(); }
+    if (!error_msg.empty()) { Callback().Call({Napi::Error::New(Env(), error_msg).Value()}); return; }
+    Cursor* c = cursor;
+    results.lob_value = [c](Napi::Env, sacapi_u32 column, uint64_t size, uint64_t position) {
+        return Lob::New(c, column, size, position);
+    };
+    Callback().Call({Env().Null(), results.toJS(Env(), cursor->options)});
+}
+
+CursorCloseWorker::CursorCloseWorker(Cursor* c, const Napi::Function& cb)
+    : ConnectionWorker(c->connection, c->Value(), cb), cursor(c), conn_obj(c->connection), state(c->state) {}
+void CursorCloseWorker::Execute() {
+    if (!conn_obj || !state) { return; }
+    uv_mutex_lock(&conn_obj->conn_mutex);
+    if (!state->closed) { conn_obj->closeCursor(state.get()); }
+    uv_mutex_unlock(&conn_obj->conn_mutex);
+}
+void CursorCloseWorker::OnOK() {
+    Napi::HandleScope scope(Env());
+    cursor->detach();
+    Callback().Call({Env().Null()});
+}
+
+CursorReleaseWorker::CursorReleaseWorker(Connection* c, Napi::Env env, std::shared_ptr<CursorState> s)
+    : ConnectionWorker(c, env), conn_obj(c), state(std::move(s)) {}
+void CursorReleaseWorker::Execute() {
+    uv_mutex_lock(&conn_obj->conn_mutex);
+    if (!state->closed) { conn_obj->closeCursor(state.get()); }
+    uv_mutex_unlock(&conn_obj->conn_mutex);
+}
+void CursorReleaseWorker::OnOK() {}
+
+LobReadWorker::LobReadWorker(Lob* l, const Napi::Function& cb, size_t n)
+    : ConnectionWorker(l->cursor->connection, l->Value(), cb), lob(l), conn_obj(l->cursor->connection),
+      max_bytes(n), error_msg("") {}
+void LobReadWorker::Execute() {
+    lob->readChunk(conn_obj, max_bytes, chunk, error_msg);
+}
+void LobReadWorker::OnOK() {
+    Napi::HandleScope scope(Env());
+    if (!error_msg.empty()) { Callback().Call({Napi::Error::New(Env(), error_msg).Value()}); }
+    else if (chunk.empty()) { Callback().Call({Env().Null(), Env().Null()}); }
+    else { Callback().Call({Env().Null(), Napi::Buffer<char>::Copy(Env(), chunk.data(), chunk.size())}); }
+}
@@ -0,0 +1,463 @@
+#include "h/batch_params.h"
+#include "h/param_stream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// A chunk's bind arrays stay within this budget (a single wider row still
+// gets a chunk of its own), and hold at most BATCH_MAX_ROWS rows.
+static const size_t BATCH_BUFFER_BUDGET = 4 << 20;
+static const size_t BATCH_MAX_ROWS = 4096;
+
+// What a parameter value can be bound as. Values of other types bind NULL,
+// as they do for Statement.exec.
+enum class CellKind : uint8_t { Null, Int32, Int64, Uint64, Double, Text, Binary };
+
+static CellKind classify(const Napi::Value& val, bool& negative) {
+    if (val.IsBuffer()) { return CellKind::Binary; }
+    if (val.IsString()) { return CellKind::Text; }
+    if (val.IsNumber()) {
+        double num = val.As<Napi::Number>().DoubleValue();
+        negative = negative || num < 0;
+        if (std::floor(num) != num || num >= 9007199254740991.0 || num <= -9007199254740991.0) { return CellKind::Double; }
+        return num >= -2147483648.0 && num <= 2147483647.0 ? CellKind::Int32 : CellKind::Int64;
+    }
+    if (val.IsBigInt()) {
+        bool lossless = false;
+        int64_t v = val.As<Napi::BigInt>().Int64Value(&lossless);
+        if (lossless) {
+            negative = negative || v < 0;
+            return CellKind::Int64;
+        }
+        val.As<Napi::BigInt>().Uint64Value(&lossless);
+        return lossless ? CellKind::Uint64 : CellKind::Text;
+    }
+    return CellKind::Null;
+}
+
+// The one type a parameter is bound with, given the kinds of its values.
+static bool columnType(const std::vector<bool>& seen, bool negative, size_t index,
+                       a_sqlany_data_type& type, std::string& error_msg) {
+    auto has = [&](CellKind kind) { return seen[(size_t)kind]; };
+    if (has(CellKind::Binary)) {
+        if (has(CellKind::Int32) || has(CellKind::Int64) || has(CellKind::Uint64) ||
+            has(CellKind::Double) || has(CellKind::Text)) {
+            error_msg = "execBatch: parameter " + std::to_string(index) + " mixes Buffer and non-Buffer values.";
+            return false;
+        }
+        type = A_BINARY;
+    } else if (has(CellKind::Text) || (has(CellKind::Uint64) && negative) || (!has(CellKind::Int32) &&
+               !has(CellKind::Int64) && !has(CellKind::Uint64) && !has(CellKind::Double))) {
+        type = A_STRING;
+    } else if (has(CellKind::Double)) {
+        type = A_DOUBLE;
+    } else if (has(CellKind::Uint64)) {
+        type = A_UVAL64;
+    } else if (has(CellKind::Int64)) {
+        type = A_VAL64;
+    } else {
+        type = A_VAL32;
+    }
+    return true;
+}
+
+static size_t align8(size_t n) { return (n + 7) & ~(size_t)7; }
+
+// Writes a non-NULL value into its fixed-width slot.
+static void writeFixed(char* at, a_sqlany_data_type type, const Napi::Value& val) {
+    double num = 0;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    bool lossless = false;
+    if (val.IsBigInt()) {
+        i64 = val.As<Napi::BigInt>().Int64Value(&lossless);
+        u64 = val.As<Napi::BigInt>().Uint64Value(&lossless);
+        num = lossless ? (double)u64 : (double)i64;
+    } else {
+        num = val.As<Napi::Number>().DoubleValue();
+        i64 = (int64_t)num;
+        u64 = num < 0 ? 0 : (uint64_t)num;
+    }
+    switch (type) {
+        case A_VAL32: { int32_t v = (int32_t)i64; memcpy(at, &v, sizeof(v)); break; }
+        case A_VAL64: memcpy(at, &i64, sizeof(i64)); break;
+        case A_UVAL64: memcpy(at, &u64, sizeof(u64)); break;
+        default: memcpy(at, &num, sizeof(num)); break;
+    }
+}
+
+bool BatchParams::fromRows(const Napi::Array& rows, std::string& error_msg) {
+    size_t num_rows = rows.Length();
+    size_t num_params = 0;
+    std::vector<Napi::Value> cells;
+    for (size_t r = 0; r < num_rows; r++) {
+        Napi::Value row = rows.Get((uint32_t)r);
+        if (!row.IsArray()) {
+            error_msg = "execBatch expects an array of parameter arrays.";
+            return false;
+        }
+        Napi::Array values = row.As<Napi::Array>();
+        if (r == 0) {
+            num_params = values.Length();
+            cells.reserve(num_rows * num_params);
+        } else if (values.Length() != num_params) {
+            error_msg = "execBatch: row " + std::to_string(r) + " has " + std::to_string(values.Length()) +
+                        " parameters, expected " + std::to_string(num_params) + ".";
+            return false;
+        }
+        for (uint32_t c = 0; c < num_params; c++) {
+            cells.push_back(values.Get(c));
+            if (ParamStream::IsSource(cells.back())) {
+                error_msg = "execBatch does not accept stream parameters.";
+                return false;
+            }
+        }
+    }
+
+    // Settle each parameter's type, then measure the variable-width values.
+    std::vector<CellKind> kinds(cells.size());
+    std::vector<a_sqlany_data_type> types(num_params);
+    for (size_t c = 0; c < num_params; c++) {
+        std::vector<bool> seen(7, false);
+        bool negative = false;
+        for (size_t r = 0; r < num_rows; r++) {
+            CellKind kind = classify(cells[r * num_params + c], negative);
+            kinds[r * num_params + c] = kind;
+            seen[(size_t)kind] = true;
+        }
+        if (!columnType(seen, negative, c, types[c], error_msg)) {
+            return false;
+        }
+    }
+    std::vector<size_t> lengths(cells.size(), 0);
+    for (size_t i = 0; i < cells.size(); i++) {
+        a_sqlany_data_type type = types[i % num_params];
+        if (kinds[i] == CellKind::Null) {
+            continue;
+        }
+        if (type == A_BINARY) {
+            lengths[i] = cells[i].As<Napi::Buffer<char>>().Length();
+        } else if (type == A_STRING) {
+            if (!cells[i].IsString()) { cells[i] = cells[i].ToString(); }
+            napi_get_value_string_utf8(cells[i].Env(), cells[i], nullptr, 0, &lengths[i]);
+        }
+    }
+
+    // Cut the rows into chunks. Each chunk lays its rows out as structs of
+    // lengths, NULL flags, then one slot per parameter sized for the
+    // chunk's widest value.
+    size_t first = 0;
+    while (first < num_rows) {
+        std::vector<size_t> widths(num_params, 0);
+        for (size_t c = 0; c < num_params; c++) {
+            widths[c] = types[c] == A_STRING || types[c] == A_BINARY ? 1 : types[c] == A_VAL32 ? 4 : 8;
+        }
+        size_t row_size = 0;
+        size_t count = 0;
+        while (first + count < num_rows && count < BATCH_MAX_ROWS) {
+            std::vector<size_t> next = widths;
+            size_t r = first + count;
+            for (size_t c = 0; c < num_params; c++) {
+                if (types[c] == A_STRING || types[c] == A_BINARY) {
+                    next[c] = std::max(next[c], lengths[r * num_params + c] + 1);
+                }
+            }
+            size_t next_size = align8(num_params * (sizeof(size_t) + sizeof(sacapi_bool)));
+            for (size_t c = 0; c < num_params; c++) { next_size += align8(next[c]); }
+            if (count > 0 && next_size * (count + 1) > BATCH_BUFFER_BUDGET) {
+                break;
+            }
+            widths.swap(next);
+            row_size = std::max<size_t>(next_size, 8);
+            count++;
+        }
+
+        Chunk chunk;
+        chunk.rows = count;
+        chunk.row_size = row_size;
+        chunk.data.assign(count * row_size, 0);
+        char* base = chunk.data.data();
+        size_t offset = align8(num_params * (sizeof(size_t) + sizeof(sacapi_bool)));
+        for (size_t c = 0; c < num_params; c++) {
+            BoundColumn col;
+            col.type = types[c];
+            col.width = widths[c];
+            col.length = reinterpret_cast<size_t*>(base + c * sizeof(size_t));
+            col.is_null = reinterpret_cast<sacapi_bool*>(base + num_params * sizeof(size_t) + c * sizeof(sacapi_bool));
+            col.value = base + offset;
+            offset += align8(widths[c]);
+            chunk.columns.push_back(col);
+        }
+        for (size_t r = 0; r < count; r++) {
+            size_t at = r * row_size;
+            for (size_t c = 0; c < num_params; c++) {
+                const BoundColumn& col = chunk.columns[c];
+                char* value = col.value + at;
+                size_t i = (first + r) * num_params + c;
+                size_t length = lengths[i];
+                if (kinds[i] == CellKind::Null) {
+                    sacapi_bool is_null = 1;
+                    memcpy(reinterpret_cast<char*>(col.is_null) + at, &is_null, sizeof(is_null));
+                } else if (col.type == A_BINARY) {
+                    memcpy(value, cells[i].As<Napi::Buffer<char>>().Data(), length);
+                } else if (col.type == A_STRING) {
+                    napi_get_value_string_utf8(cells[i].Env(), cells[i], value, length + 1, &length);
+                } else {
+                    writeFixed(value, col.type, cells[i]);
+                    length = col.width;
+                }
+                memcpy(reinterpret_cast<char*>(col.length) + at, &length, sizeof(length));
+            }
+        }
+        // Moving the chunk keeps data's buffer, so the pointers stay valid.
+        chunks.push_back(std::move(chunk));
+        first += count;
+    }
+    return true;
+}
+
+char* BatchParams::own(size_t bytes) {
+    storage.emplace_back(new char[std::max<size_t>(bytes, 1)]());
+    return storage.back().get();
+}
+
+// The type a typed array's elements are bound in place as. Float32Array is
+// left to the caller since A_FLOAT needs API version 5.
+static bool typedArrayBindType(napi_typedarray_type array_type, a_sqlany_data_type& type) {
+    switch (array_type) {
+        case napi_int8_array: type = A_VAL8; return true;
+        case napi_uint8_array:
+        case napi_uint8_clamped_array: type = A_UVAL8; return true;
+        case napi_int16_array: type = A_VAL16; return true;
+        case napi_uint16_array: type = A_UVAL16; return true;
+        case napi_int32_array: type = A_VAL32; return true;
+        case napi_uint32_array: type = A_UVAL32; return true;
+        case napi_float64_array: type = A_DOUBLE; return true;
+        case napi_bigint64_array: type = A_VAL64; return true;
+        case napi_biguint64_array: type = A_UVAL64; return true;
+        default: return false;
+    }
+}
+
+static char* typedArrayData(const Napi::TypedArray& array) {
+    return static_cast<char*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+}
+
+// ORs a column's NULL flags (any truthy value) into `is_null`.
+static bool readNullFlags(const Napi::Value& value, const std::string& name, size_t rows,
+                          sacapi_bool* is_null, std::string& error_msg) {
+    size_t length = value.IsTypedArray() ? value.As<Napi::TypedArray>().ElementLength()
+                  : value.IsArray() ? value.As<Napi::Array>().Length() : (size_t)-1;
+    if (length != rows) {
+        error_msg = "execBatchColumns: nulls." + name + " must be an array with one flag per row.";
+        return false;
+    }
+    if (value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array) {
+        const uint8_t* flags = reinterpret_cast<const uint8_t*>(typedArrayData(value.As<Napi::TypedArray>()));
+        for (size_t r = 0; r < rows; r++) { is_null[r] |= flags[r] != 0; }
+    } else if (value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_int32_array) {
+        const int32_t* flags = reinterpret_cast<const int32_t*>(typedArrayData(value.As<Napi::TypedArray>()));
+        for (size_t r = 0; r < rows; r++) { is_null[r] |= flags[r] != 0; }
+    } else {
+        Napi::Object flags = value.As<Napi::Object>();
+        for (size_t r = 0; r < rows; r++) { is_null[r] |= flags.Get((uint32_t)r).ToBoolean().Value(); }
+    }
+    return true;
+}
+
+bool BatchParams::fromColumns(const Napi::Object& columns, const Napi::Value& nulls, std::string& error_msg) {
+    Napi::Array names = columns.GetPropertyNames();
+    size_t num_params = names.Length();
+    if (num_params == 0) {
+        error_msg = "execBatchColumns expects at least one column.";
+        return false;
+    }
+    bool has_flags = !nulls.IsUndefined() && !nulls.IsNull();
+    if (has_flags && !nulls.IsObject()) {
+        error_msg = "execBatchColumns: nulls must be an object of per-column NULL flags.";
+        return false;
+    }
+    Napi::Object flags = has_flags ? nulls.As<Napi::Object>() : Napi::Object();
+    if (has_flags) {
+        Napi::Array flag_names = flags.GetPropertyNames();
+        for (uint32_t i = 0; i < flag_names.Length(); i++) {
+            if (!columns.Has(flag_names.Get(i))) {
+                error_msg = "execBatchColumns: nulls names unknown column '" + flag_names.Get(i).ToString().Utf8Value() + "'.";
+                return false;
+            }
+        }
+    }
+
+    size_t num_rows = 0;
+    std::vector<BoundColumn> bound(num_params);
+    for (uint32_t c = 0; c < num_params; c++) {
+        Napi::Value key = names.Get(c);
+        std::string name = key.ToString().Utf8Value();
+        Napi::Value column = columns.Get(key);
+        BoundColumn& col = bound[c];
+        col.length = nullptr;
+        col.is_null = nullptr;
+        size_t rows = 0;
+        if (column.IsTypedArray()) {
+            Napi::TypedArray array = column.As<Napi::TypedArray>();
+            rows = array.ElementLength();
+            col.width = array.ElementSize();
+            col.value = typedArrayData(array);
+            if (array.TypedArrayType() == napi_float32_array) {
+#if _SACAPI_VERSION+0 >= SQLANY_API_VERSION_5
+                col.type = A_FLOAT;
+                if (apiVersion < SQLANY_API_VERSION_5)
+#endif
+                {
+                    // Clients before API version 5 have no single precision
+                    // type, so the column is copied as doubles.
+                    const float* source = reinterpret_cast<const float*>(col.value);
+                    double* widened = reinterpret_cast<double*>(own(rows * sizeof(double)));
+                    for (size_t r = 0; r < rows; r++) { widened[r] = source[r]; }
+                    col.type = A_DOUBLE;
+                    col.width = sizeof(double);
+                    col.value = reinterpret_cast<char*>(widened);
+                }
+            } else if (!typedArrayBindType(array.TypedArrayType(), col.type)) {
+                error_msg = "execBatchColumns: column '" + name + "' has an unsupported typed array type.";
+                return false;
+            }
+            pinned.push_back(Napi::Persistent(column.As<Napi::Object>()));
+        } else if (column.IsArray()) {
+            // Strings are copied once into a single array sized for the
+            // longest value, as column-wise binding needs a fixed stride.
+            Napi::Array values = column.As<Napi::Array>();
+            rows = values.Length();
+            std::vector<Napi::Value> strings(rows);
+            size_t* lengths = reinterpret_cast<size_t*>(own(rows * sizeof(size_t)));
+            bool any_null = false;
+            size_t width = 1;
+            for (uint32_t r = 0; r < rows; r++) {
+                strings[r] = values.Get(r);
+                if (strings[r].IsNull() || strings[r].IsUndefined()) {
+                    any_null = true;
+                } else if (strings[r].IsString()) {
+                    napi_get_value_string_utf8(strings[r].Env(), strings[r], nullptr, 0, &lengths[r]);
+                    width = std::max(width, lengths[r] + 1);
+                } else {
+                    error_msg = "execBatchColumns: column '" + name + "' must hold only strings and nulls.";
+                    return false;
+                }
+            }
+            col.type = A_STRING;
+            col.width = width;
+            col.value = own(rows * width);
+            col.length = lengths;
+            if (any_null) {
+                col.is_null = reinterpret_cast<sacapi_bool*>(own(rows * sizeof(sacapi_bool)));
+            }
+            for (size_t r = 0; r < rows; r++) {
+                if (strings[r].IsString()) {
+                    napi_get_value_string_utf8(strings[r].Env(), strings[r], col.value + r * width, width, &lengths[r]);
+                } else {
+                    col.is_null[r] = 1;
+                }
+            }
+        } else {
+            error_msg = "execBatchColumns: column '" + name + "' must be a typed array or an array of strings.";
+            return false;
+        }
+        if (c == 0) {
+            num_rows = rows;
+        } else if (rows != num_rows) {
+            error_msg = "execBatchColumns: column '" + name + "' has " + std::to_string(rows) +
+                        " values, expected " + std::to_string(num_rows) + ".";
+            return false;
+        }
+
+        if (has_flags && flags.Has(key)) {
+            Napi::Value column_flags = flags.Get(key);
+            if (!col.is_null && column_flags.IsTypedArray() &&
+                column_flags.As<Napi::TypedArray>().TypedArrayType() == napi_int32_array &&
+                column_flags.As<Napi::TypedArray>().ElementLength() == rows) {
+                // Int32Array flags already have the client's layout.
+                col.is_null = reinterpret_cast<sacapi_bool*>(typedArrayData(column_flags.As<Napi::TypedArray>()));
+                pinned.push_back(Napi::Persistent(column_flags.As<Napi::Object>()));
+            } else {
+                if (!col.is_null) {
+                    col.is_null = reinterpret_cast<sacapi_bool*>(own(rows * sizeof(sacapi_bool)));
+                }
+                if (!readNullFlags(column_flags, name, rows, col.is_null, error_msg)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (size_t first = 0; first < num_rows; first += BATCH_MAX_ROWS) {
+        Chunk chunk;
+        chunk.rows = std::min(BATCH_MAX_ROWS, num_rows - first);
+        for (BoundColumn col : bound) {
+            col.value += first * col.width;
+            if (col.length) { col.length += first; }
+            if (col.is_null) { col.is_null += first; }
+            chunk.columns.push_back(col);
+        }
+        chunks.push_back(std::move(chunk));
+    }
+    return true;
+}
+
+// Binds every parameter to `row` of the chunk. With the chunk's bind type
+// in effect the client finds the following rows itself.
+bool BatchParams::bindRow(a_sqlany_stmt* stmt, Chunk& chunk, size_t row) {
+    for (size_t c = 0; c < chunk.columns.size(); c++) {
+        const BoundColumn& col = chunk.columns[c];
+        size_t value_step = chunk.row_size ? chunk.row_size : col.width;
+        size_t length_step = chunk.row_size ? chunk.row_size : sizeof(size_t);
+        size_t null_step = chunk.row_size ? chunk.row_size : sizeof(sacapi_bool);
+        a_sqlany_bind_param p;
+        memset(&p, 0, sizeof(p));
+        p.direction = DD_INPUT;
+        p.value.type = col.type;
+        p.value.buffer = col.value + row * value_step;
+        p.value.buffer_size = col.width;
+        if (col.length) {
+            p.value.length = reinterpret_cast<size_t*>(reinterpret_cast<char*>(col.length) + row * length_step);
+        }
+        if (col.is_null) {
+            p.value.is_null = reinterpret_cast<sacapi_bool*>(reinterpret_cast<char*>(col.is_null) + row * null_step);
+        }
+        if (!api.sqlany_bind_param(stmt, (sacapi_u32)c, &p)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BatchParams::execute(a_sqlany_stmt* stmt, a_sqlany_connection* conn, uint64_t& affected_rows, std::string& error_msg) {
+    bool wide = apiVersion >= SQLANY_API_VERSION_4 && api.sqlany_set_batch_size != NULL &&
+                api.sqlany_set_param_bind_type != NULL;
+    bool ok = true;
+    for (size_t i = 0; ok && i < chunks.size(); i++) {
+        Chunk& chunk = chunks[i];
+        if (wide && chunk.rows > 1) {
+            ok = api.sqlany_set_param_bind_type(stmt, chunk.row_size) &&
+                 api.sqlany_set_batch_size(stmt, (sacapi_u32)chunk.rows) &&
+                 bindRow(stmt, chunk, 0) && api.sqlany_execute(stmt);
+            if (ok) { affected_rows += (uint64_t)std::max(0, (int)api.sqlany_affected_rows(stmt)); }
+            continue;
+        }
+        if (wide) {
+            ok = api.sqlany_set_param_bind_type(stmt, 0) && api.sqlany_set_batch_size(stmt, 1);
+        }
+        for (size_t r = 0; ok && r < chunk.rows; r++) {
+            ok = bindRow(stmt, chunk, r) && api.sqlany_execute(stmt);
+            if (ok) { affected_rows += (uint64_t)std::max(0, (int)api.sqlany_affected_rows(stmt)); }
+        }
+    }
+    if (!ok) {
+        getErrorMsg(conn, error_msg);
+    }
+    if (wide) {
+        // Leave the statement as Statement.exec expects it.
+        api.sqlany_set_batch_size(stmt, 1);
+        api.sqlany_set_param_bind_type(stmt, 0);
+    }
+    return ok;
+}
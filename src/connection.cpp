@@ -10,6 +10,9 @@ Napi::Object Connection::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("disconnect", &Connection::Disconnect),
         InstanceMethod("close", &Connection::Disconnect),
         InstanceMethod("exec", &Connection::Exec),
+        InstanceMethod("queryOne", &Connection::QueryOne),
+        InstanceMethod("queryScalar", &Connection::QueryScalar),
+        InstanceMethod("exportToFile", &Connection::ExportToFile),
         InstanceMethod("prepare", &Connection::Prepare),
         InstanceMethod("commit", &Connection::Commit),
         InstanceMethod("rollback", &Connection::Rollback),
@@ -21,12 +24,22 @@ Napi::Object Connection::Init(Napi::Env env, Napi::Object exports) {
     return exports;
 }
 
-Connection::Connection(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Connection>(info) {
+Connection::Connection(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Connection>(info), executor(this) {
     this->conn = NULL;
     uv_mutex_init(&this->conn_mutex);
+    if (info.Length() > 0 && info[0].IsObject()) {
+        std::string error_msg;
+        if (!parseQueryOptions(info[0], this->defaults, error_msg)) {
+            throwNapiTypeError(info.Env(), error_msg);
+        }
+    }
 }
 
 Connection::~Connection() {
+    // Nothing may run on the connection's thread while it is torn down, such
+    // as the clean-up of a cursor collected together with the connection.
+    executor.stop();
+    detachCursors();
     uv_mutex_lock(&this->conn_mutex);
     cleanupStmts();
     if (this->conn) {
@@ -48,7 +61,40 @@ void Connection::removeStmt(StmtObject* stmt) {
     }
 }
 
+void Connection::removeCursor(Cursor* cursor) {
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (cursors[i] == cursor) {
+            cursors.erase(cursors.begin() + i);
+            break;
+        }
+    }
+}
+
+// Main thread: the cursors can no longer be read once the connection is
+// closed or destroyed.
+void Connection::detachCursors() {
+    while (!cursors.empty()) {
+        cursors.back()->detach();
+    }
+}
+
+// conn_mutex held.
+void Connection::closeCursor(CursorState* state) {
+    state->close();
+    for (size_t i = 0; i < cursor_states.size(); ++i) {
+        if (cursor_states[i].get() == state) {
+            cursor_states.erase(cursor_states.begin() + i);
+            break;
+        }
+    }
+}
+
 void Connection::cleanupStmts() {
+    // Cursors go first: their statements must be freed before the connection.
+    for (auto const& state : cursor_states) {
+        state->close();
+    }
+    cursor_states.clear();
     for (auto const& stmt : statements) {
         stmt->cleanup();
     }
@@ -86,42 +132,95 @@ Napi::Value Connection::Disconnect(const Napi::CallbackInfo& info) {
 }
 
 Napi::Value Connection::Exec(const Napi::CallbackInfo& info) {
+    return queueExec(info, "exec", ResultShape::Rows);
+}
+
+Napi::Value Connection::QueryOne(const Napi::CallbackInfo& info) {
+    return queueExec(info, "queryOne", ResultShape::FirstRow);
+}
+
+Napi::Value Connection::QueryScalar(const Napi::CallbackInfo& info) {
+    return queueExec(info, "queryScalar", ResultShape::Scalar);
+}
+
+Napi::Value Connection::queueExec(const Napi::CallbackInfo& info, const char* method, ResultShape shape) {
     Napi::Env env = info.Env();
-    int sql_idx = 0;
-    int params_idx = -1;
-    int callback_idx = 1;
     if (info.Length() < 2) {
-        throwNapiError(env, "exec requires at least a SQL string and a callback.");
+        throwNapiError(env, std::string(method) + " requires at least a SQL string and a callback.");
+        return env.Undefined();
+    }
+    size_t callback_idx = info.Length() - 1;
+    if (!info[0].IsString() || !info[callback_idx].IsFunction()) {
+        throwNapiError(env, std::string("Invalid arguments for ") + method + ": expecting (sql, [params], [options], callback).");
+        return env.Undefined();
+    }
+    Napi::Array params = Napi::Array::New(env);
+    QueryOptions options = this->defaults;
+    std::string error_msg;
+    if (!parseExecArgs(info, 1, callback_idx, method, params, options, error_msg)) {
+        throwNapiTypeError(env, error_msg);
         return env.Undefined();
     }
-    if (info.Length() > 2) {
-        params_idx = 1;
-        callback_idx = 2;
+    applyResultShape(options, shape);
+    std::string sql = info[0].ToString().Utf8Value();
+    Napi::Function callback = info[callback_idx].As<Napi::Function>();
+    (new ExecWorker(this, callback, sql, params, options))->Queue();
+    return env.Undefined();
+}
+
+Napi::Value Connection::ExportToFile(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    size_t callback_idx = info.Length() - 1;
+    if (info.Length() < 3 || !info[0].IsString() || !info[callback_idx].IsFunction() ||
+        !info[callback_idx - 1].IsObject() || info[callback_idx - 1].IsArray()) {
+        throwNapiError(env, "Invalid arguments for exportToFile: expecting (sql, [params], options, callback).");
+        return env.Undefined();
     }
-    if (!info[sql_idx].IsString() || !info[callback_idx].IsFunction()) {
-        throwNapiError(env, "Invalid arguments for exec: expecting (sql, [params], callback).");
+    Napi::Array params = Napi::Array::New(env);
+    if (callback_idx == 3 && info[1].IsArray()) {
+        params = info[1].As<Napi::Array>();
+    } else if (callback_idx == 3 && !info[1].IsNull() && !info[1].IsUndefined()) {
+        throwNapiError(env, "Parameters for exportToFile must be an array.");
+        return env.Undefined();
+    } else if (callback_idx > 3) {
+        throwNapiError(env, "Invalid arguments for exportToFile: expecting (sql, [params], options, callback).");
         return env.Undefined();
     }
-    if (params_idx != -1 && !info[params_idx].IsArray()) {
-        throwNapiError(env, "Parameters for exec must be an array.");
+    ExportOptions options;
+    std::string error_msg;
+    if (!parseExportOptions(info[callback_idx - 1], options, error_msg)) {
+        throwNapiError(env, error_msg);
         return env.Undefined();
     }
-    std::string sql = info[sql_idx].ToString().Utf8Value();
-    Napi::Array params = (params_idx != -1) ? info[params_idx].As<Napi::Array>() : Napi::Array::New(env);
+    std::string sql = info[0].ToString().Utf8Value();
     Napi::Function callback = info[callback_idx].As<Napi::Function>();
-    (new ExecWorker(this, callback, sql, params))->Queue();
+    (new ExportWorker(this, callback, sql, params, options))->Queue();
     return env.Undefined();
 }
 
 Napi::Value Connection::Prepare(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction()) {
+    size_t callback_idx = info.Length() - 1;
+    if (info.Length() < 2 || info.Length() > 3 || !info[0].IsString() || !info[callback_idx].IsFunction()) {
         throwNapiError(env, "prepare requires a SQL string and a callback function.");
         return env.Undefined();
     }
+    std::vector<a_sqlany_data_type> types;
+    if (callback_idx == 2 && !info[1].IsUndefined() && !info[1].IsNull()) {
+        if (!info[1].IsObject() || info[1].IsArray()) {
+            throwNapiError(env, "Invalid prepare options: expecting an object.");
+            return env.Undefined();
+        }
+        std::string error_msg;
+        Napi::Value hints = info[1].As<Napi::Object>().Get("types");
+        if (!hints.IsUndefined() && !parseParamTypes(hints, types, error_msg)) {
+            throwNapiError(env, error_msg);
+            return env.Undefined();
+        }
+    }
     std::string sql = info[0].ToString().Utf8Value();
-    Napi::Function callback = info[1].As<Napi::Function>();
-    (new PrepareWorker(this, callback, sql))->Queue();
+    Napi::Function callback = info[callback_idx].As<Napi::Function>();
+    (new PrepareWorker(this, callback, sql, std::move(types)))->Queue();
     return env.Undefined();
 }
 
@@ -0,0 +1,125 @@
+#include "h/cursor.h"
+#include "h/connection.h"
+#include "h/stmt.h"
+#include "h/async_workers.h"
+#include <cmath>
+
+Napi::FunctionReference Cursor::constructor;
+
+Napi::Object Cursor::Init(Napi::Env env, Napi::Object exports) {
+    Napi::HandleScope scope(env);
+    Napi::Function func = DefineClass(env, "Cursor", {
+        InstanceMethod("fetch", &Cursor::Fetch),
+        InstanceMethod("close", &Cursor::Close),
+        InstanceAccessor("done", &Cursor::Done, nullptr),
+    });
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+    exports.Set("Cursor", func);
+    return exports;
+}
+
+Cursor::Cursor(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Cursor>(info) {
+    this->connection = NULL;
+    this->done = true;
+}
+
+Cursor::~Cursor() {
+    if (this->connection) {
+        this->connection->removeCursor(this);
+        // This runs in the garbage collector, which must not wait for the
+        // connection: an owned statement is freed on the connection's thread.
+        if (!this->done && this->stmt_ref.IsEmpty()) {
+            (new CursorReleaseWorker(this->connection, Env(), this->state))->Queue();
+        }
+    }
+}
+
+void Cursor::open(Connection* conn_obj, std::shared_ptr<CursorState> state, const ResultSet& layout, const QueryOptions& options) {
+    this->connection = conn_obj;
+    this->state = std::move(state);
+    this->layout = layout;
+    this->options = options;
+    this->done = false;
+    this->connection->cursors.push_back(this);
+}
+
+void Cursor::open(StmtObject* stmt_obj, unsigned int generation, const ResultSet& layout, const QueryOptions& options) {
+    this->connection = stmt_obj->connection;
+    this->state = std::make_shared<CursorState>();
+    this->state->stmt_obj = stmt_obj;
+    this->state->generation = generation;
+    // Kept until the cursor is collected, so that a fetch still queued when
+    // the cursor is detached does not read a collected statement.
+    this->stmt_ref = Napi::Persistent(stmt_obj->Value());
+    this->layout = layout;
+    this->options = options;
+    this->done = false;
+    this->connection->cursors.push_back(this);
+}
+
+void Cursor::detach() {
+    this->done = true;
+    if (this->connection) {
+        this->connection->removeCursor(this);
+        this->connection = NULL;
+    }
+}
+
+a_sqlany_stmt* CursorState::statement(std::string& error_msg) {
+    if (this->owned_stmt) {
+        return this->owned_stmt;
+    }
+    if (!this->stmt_obj || !this->stmt_obj->sqlany_stmt) {
+        error_msg = "Cursor is no longer valid: the statement has been dropped.";
+        return NULL;
+    }
+    if (this->stmt_obj->generation != this->generation) {
+        error_msg = "Cursor is no longer valid: the statement has been executed again.";
+        return NULL;
+    }
+    return this->stmt_obj->sqlany_stmt;
+}
+
+void CursorState::close() {
+    if (this->owned_stmt) {
+        api.sqlany_free_stmt(this->owned_stmt);
+        this->owned_stmt = NULL;
+    }
+    this->closed = true;
+}
+
+Napi::Value Cursor::Fetch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[info.Length() - 1].IsFunction()) {
+        throwNapiError(env, "Cursor.fetch requires a callback function.");
+        return env.Undefined();
+    }
+    uint32_t max_rows = this->options.fetch_size;
+    if (info.Length() > 1 && !info[0].IsUndefined() && !info[0].IsNull()) {
+        // Uint32Value() would wrap 2^32 to 0, which reads as "no more rows".
+        double rows = info[0].IsNumber() ? info[0].As<Napi::Number>().DoubleValue() : 0;
+        if (!(rows >= 1 && rows <= 4294967295.0) || std::floor(rows) != rows) {
+            throwNapiTypeError(env, "Cursor.fetch expects an integer number of rows from 1 to 4294967295.");
+            return env.Undefined();
+        }
+        max_rows = (uint32_t)rows;
+    }
+    Napi::Function callback = info[info.Length() - 1].As<Napi::Function>();
+    (new CursorFetchWorker(this, callback, max_rows))->Queue();
+    return env.Undefined();
+}
+
+Napi::Value Cursor::Close(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        throwNapiError(env, "Cursor.close requires a callback function.");
+        return env.Undefined();
+    }
+    (new CursorCloseWorker(this, info[0].As<Napi::Function>()))->Queue();
+    return env.Undefined();
+}
+
+Napi::Value Cursor::Done(const Napi::CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), this->done);
+}
@@ -0,0 +1,122 @@
+#include "h/executor.h"
+#include "h/connection.h"
+
+Executor::Executor(Connection* o) : owner(o) {
+    uv_mutex_init(&mutex);
+    uv_cond_init(&cond);
+}
+
+Executor::~Executor() {
+    // No request is pending here: the connection is referenced while one is.
+    stop();
+    if (completions_state) {
+        if (completions_state->finalized) {
+            delete completions_state;
+        } else {
+            // The finalizer runs after the release and frees the state.
+            completions_state->orphaned = true;
+            completions.Release();
+        }
+    }
+    uv_cond_destroy(&cond);
+    uv_mutex_destroy(&mutex);
+}
+
+void Executor::stop() {
+    if (!started) {
+        return;
+    }
+    uv_mutex_lock(&mutex);
+    stopping = true;
+    std::deque<ConnectionWorker*> dropped;
+    dropped.swap(queue);
+    uv_cond_signal(&cond);
+    uv_mutex_unlock(&mutex);
+    uv_thread_join(&thread);
+    started = false;
+    for (ConnectionWorker* worker : dropped) {
+        worker->discard();
+    }
+}
+
+void Executor::submit(Napi::Env env, ConnectionWorker* worker) {
+    if (!started) {
+        CompletionsState* state = new CompletionsState();
+        completions_state = state;
+        completions = Napi::ThreadSafeFunction::New(env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+                                                    "sqlanywhere.Connection", 0, 1, [state](Napi::Env) {
+            state->finalized = true;
+            if (state->orphaned) {
+                delete state;
+            }
+        });
+        uv_thread_create(&thread, run, this);
+        started = true;
+    }
+    if (pending++ == 0) {
+        owner->Ref();
+        completions.Ref(env);
+    }
+    uv_mutex_lock(&mutex);
+    queue.push_back(worker);
+    uv_cond_signal(&cond);
+    uv_mutex_unlock(&mutex);
+}
+
+void Executor::finished(Napi::Env env) {
+    if (--pending == 0) {
+        // Idle connections neither hold the process open nor stay reachable.
+        completions.Unref(env);
+        owner->Unref();
+    }
+}
+
+void Executor::run(void* arg) {
+    Executor* self = static_cast<Executor*>(arg);
+    uv_mutex_lock(&self->mutex);
+    while (true) {
+        while (self->queue.empty() && !self->stopping) {
+            uv_cond_wait(&self->cond, &self->mutex);
+        }
+        if (self->queue.empty()) {
+            break;
+        }
+        ConnectionWorker* worker = self->queue.front();
+        self->queue.pop_front();
+        uv_mutex_unlock(&self->mutex);
+        worker->Execute();
+        self->completions.BlockingCall(worker, [](Napi::Env env, Napi::Function, ConnectionWorker* done) {
+            done->complete(env);
+        });
+        uv_mutex_lock(&self->mutex);
+    }
+    uv_mutex_unlock(&self->mutex);
+}
+
+void ConnectionWorker::Queue() {
+    if (!connection) {
+        Napi::AsyncWorker::Queue();
+        return;
+    }
+    executor = &connection->executor;
+    executor->submit(Env(), this);
+}
+
+void ConnectionWorker::SetError(const std::string& message) {
+    error = message;
+    Napi::AsyncWorker::SetError(message);
+}
+
+void ConnectionWorker::complete(Napi::Env env) {
+    Executor* done = executor;
+    {
+        Napi::HandleScope scope(env);
+        if (error.empty()) {
+            OnOK();
+        } else {
+            OnError(Napi::Error::New(env, error));
+        }
+    }
+    Destroy();
+    done->finished(env);
+}
@@ -0,0 +1,328 @@
+#include "h/export.h"
+#include "h/temporal.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+
+template <typename T>
+static void appendInteger(std::string& out, T value) {
+    char buf[24];
+    std::to_chars_result res = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, res.ptr - buf);
+}
+
+// Writes `value` the way JavaScript's Number::toString does, which is also
+// what JSON.stringify writes: the shortest digits that read back as the same
+// double, laid out as plain decimal for exponents from -7 to 20 and as
+// "1.5e+21" / "1e-7" outside that. REAL columns reach JavaScript widened to
+// double, so they are written as that double too.
+static void appendDouble(std::string& out, double value) {
+    if (value == 0) {
+        // -0 too, which JSON.stringify and String() both write as 0.
+        out.push_back('0');
+        return;
+    }
+    char buf[32];
+    char* end = std::to_chars(buf, buf + sizeof(buf) - 1, value, std::chars_format::scientific).ptr;
+    *end = '\0';
+    // buf holds [-]d[.ddd]e(+|-)xx; split it into digits and an exponent.
+    const char* p = buf;
+    if (*p == '-') {
+        out.push_back('-');
+        p++;
+    }
+    char digits[20];
+    int k = 0;
+    for (; *p != 'e'; p++) {
+        if (*p != '.') { digits[k++] = *p; }
+    }
+    int n = atoi(p + 1) + 1;  // position of the decimal point after the first digit
+    if (k <= n && n <= 21) {
+        out.append(digits, k);
+        out.append(n - k, '0');
+    } else if (0 < n && n <= 21) {
+        out.append(digits, n);
+        out.push_back('.');
+        out.append(digits + n, k - n);
+    } else if (-6 < n && n <= 0) {
+        out.append("0.");
+        out.append(-n, '0');
+        out.append(digits, k);
+    } else {
+        out.push_back(digits[0]);
+        if (k > 1) {
+            out.push_back('.');
+            out.append(digits + 1, k - 1);
+        }
+        out.push_back('e');
+        out.push_back(n - 1 < 0 ? '-' : '+');
+        appendInteger(out, n - 1 < 0 ? 1 - n : n - 1);
+    }
+}
+
+static void appendHex(std::string& out, const char* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    size_t at = out.size();
+    out.resize(at + len * 2);
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)data[i];
+        out[at + 2 * i] = digits[c >> 4];
+        out[at + 2 * i + 1] = digits[c & 15];
+    }
+}
+
+static void appendCsvText(std::string& out, const char* data, size_t len) {
+    bool quote = len == 0;
+    for (size_t i = 0; i < len && !quote; i++) {
+        char c = data[i];
+        quote = c == ',' || c == '"' || c == '\r' || c == '\n';
+    }
+    if (!quote) {
+        out.append(data, len);
+        return;
+    }
+    out.push_back('"');
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '"') { out.push_back('"'); }
+        out.push_back(data[i]);
+    }
+    out.push_back('"');
+}
+
+static void appendJsonText(std::string& out, const char* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    out.push_back('"');
+    size_t run = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)data[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(data + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                out.append("\\u00");
+                out.push_back(digits[c >> 4]);
+                out.push_back(digits[c & 15]);
+        }
+    }
+    out.append(data + run, len - run);
+    out.push_back('"');
+}
+
+// Appends a non-NULL numeric cell. Returns false for columns that are not
+// numeric, and for values with no numeric text (NaN, infinities).
+static bool appendNumber(std::string& out, const ResultColumn& col, size_t r) {
+    switch (col.storage) {
+        case ColumnStorage::Int32: appendInteger(out, col.fixedAt<int32_t>(r)); return true;
+        case ColumnStorage::Uint32: appendInteger(out, col.fixedAt<uint32_t>(r)); return true;
+        case ColumnStorage::Int64: appendInteger(out, col.fixedAt<int64_t>(r)); return true;
+        case ColumnStorage::Uint64: appendInteger(out, col.fixedAt<uint64_t>(r)); return true;
+        case ColumnStorage::Double:
+        case ColumnStorage::Timestamp: {
+            double v = col.fixedAt<double>(r);
+            if (!std::isfinite(v)) { return false; }
+            appendDouble(out, v);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static const char* cellText(const ResultColumn& col, size_t r, size_t& len) {
+    len = col.offsets[r + 1] - col.offsets[r];
+    return col.data.data() + col.offsets[r];
+}
+
+void appendCsvHeader(std::string& out, const std::vector<ResultColumn>& columns) {
+    for (size_t c = 0; c < columns.size(); c++) {
+        if (c > 0) { out.push_back(','); }
+        appendCsvText(out, columns[c].name.data(), columns[c].name.size());
+    }
+    out.append("\r\n");
+}
+
+void appendCsvRows(std::string& out, const std::vector<ResultColumn>& columns, size_t rows) {
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < columns.size(); c++) {
+            const ResultColumn& col = columns[c];
+            if (c > 0) { out.push_back(','); }
+            if (col.isNull(r) || appendNumber(out, col, r)) {
+                continue;
+            }
+            size_t len;
+            const char* text = cellText(col, r, len);
+            if (col.storage == ColumnStorage::Binary) {
+                appendHex(out, text, len);
+            } else if (col.storage == ColumnStorage::String) {
+                appendCsvText(out, text, len);
+            } else if (col.storage == ColumnStorage::Timestamp) {
+                // A DATE / TIMESTAMP value that could not be parsed keeps its text.
+                appendCsvText(out, text, len);
+            } else if (col.storage == ColumnStorage::Double) {
+                double v = col.fixedAt<double>(r);
+                out.append(std::isnan(v) ? "NaN" : v > 0 ? "Infinity" : "-Infinity");
+            }
+        }
+        out.append("\r\n");
+    }
+}
+
+static void appendJsonValue(std::string& out, const ResultColumn& col, size_t r, const JsonStyle& style) {
+    switch (col.storage) {
+        case ColumnStorage::Int64:
+        case ColumnStorage::Uint64:
+            if (style.int64 == Int64Mode::Number) {
+                double v = col.storage == ColumnStorage::Int64 ? (double)col.fixedAt<int64_t>(r) : (double)col.fixedAt<uint64_t>(r);
+                appendDouble(out, v);
+                return;
+            }
+            if (style.int64 == Int64Mode::String) { out.push_back('"'); }
+            appendNumber(out, col, r);
+            if (style.int64 == Int64Mode::String) { out.push_back('"'); }
+            return;
+        case ColumnStorage::Timestamp: {
+            double ms = col.fixedAt<double>(r);
+            if (!std::isnan(ms) && style.dates == DateMode::Date) {
+                char iso[32];
+                out.push_back('"');
+                out.append(iso, formatTimestamp(ms, iso));
+                out.push_back('"');
+                return;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    if (appendNumber(out, col, r)) {
+        return;
+    }
+    size_t len;
+    const char* text = cellText(col, r, len);
+    if (col.storage == ColumnStorage::Binary && style.buffer_objects) {
+        out.append("{\"type\":\"Buffer\",\"data\":[");
+        for (size_t i = 0; i < len; i++) {
+            if (i > 0) { out.push_back(','); }
+            appendInteger(out, (unsigned char)text[i]);
+        }
+        out.append("]}");
+    } else if (col.storage == ColumnStorage::Binary) {
+        out.push_back('"');
+        appendHex(out, text, len);
+        out.push_back('"');
+    } else if (col.storage == ColumnStorage::String || col.storage == ColumnStorage::Timestamp) {
+        appendJsonText(out, text, len);
+    } else {
+        out.append("null");
+    }
+}
+
+void appendJsonRows(std::string& out, const std::vector<ResultColumn>& columns, size_t rows, char terminator,
+                    const JsonStyle& style) {
+    std::vector<std::string> keys(columns.size());
+    for (size_t c = 0; c < columns.size(); c++) {
+        keys[c].push_back(c == 0 ? '{' : ',');
+        appendJsonText(keys[c], columns[c].name.data(), columns[c].name.size());
+        keys[c].push_back(':');
+    }
+    for (size_t r = 0; r < rows; r++) {
+        if (columns.empty()) { out.push_back('{'); }
+        for (size_t c = 0; c < columns.size(); c++) {
+            out.append(keys[c]);
+            if (columns[c].isNull(r)) { out.append("null"); }
+            else { appendJsonValue(out, columns[c], r, style); }
+        }
+        out.push_back('}');
+        out.push_back(terminator);
+    }
+}
+
+bool parseExportOptions(const Napi::Value& value, ExportOptions& options, std::string& error_msg) {
+    Napi::Object obj = value.As<Napi::Object>();
+    Napi::Value path = obj.Get("path");
+    if (!path.IsString() || path.As<Napi::String>().Utf8Value().empty()) {
+        error_msg = "exportToFile requires a path option.";
+        return false;
+    }
+    options.path = path.As<Napi::String>().Utf8Value();
+    Napi::Value format = obj.Get("format");
+    if (!format.IsUndefined()) {
+        std::string mode = format.IsString() ? format.As<Napi::String>().Utf8Value() : "";
+        if (mode == "csv") { options.format = TextFormat::Csv; }
+        else if (mode == "ndjson") { options.format = TextFormat::Ndjson; }
+        else {
+            error_msg = "Invalid format: expecting 'csv' or 'ndjson'.";
+            return false;
+        }
+    }
+    Napi::Value header = obj.Get("header");
+    if (!header.IsUndefined()) {
+        options.header = header.ToBoolean().Value();
+    }
+    return true;
+}
+
+// Synchronous uv_fs calls (no callback) run in the calling thread and never
+// touch the loop, so none is passed.
+static std::string fsError(const char* action, const std::string& path, int code) {
+    return std::string("Could not ") + action + " '" + path + "': " + uv_strerror(code);
+}
+
+FileSink::~FileSink() {
+    std::string ignored;
+    close(ignored);
+}
+
+bool FileSink::open(const std::string& file_path, std::string& error_msg) {
+    uv_fs_t req;
+    path = file_path;
+    int result = uv_fs_open(nullptr, &req, path.c_str(), UV_FS_O_WRONLY | UV_FS_O_CREAT | UV_FS_O_TRUNC, 0644, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (result < 0) {
+        error_msg = fsError("open", path, result);
+        return false;
+    }
+    fd = result;
+    return true;
+}
+
+bool FileSink::write(std::string& data, std::string& error_msg) {
+    size_t done = 0;
+    while (done < data.size()) {
+        uv_fs_t req;
+        uv_buf_t buf = uv_buf_init(&data[done], (unsigned int)std::min<size_t>(data.size() - done, 1u << 30));
+        int result = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+        uv_fs_req_cleanup(&req);
+        if (result < 0) {
+            error_msg = fsError("write to", path, result);
+            return false;
+        }
+        done += (size_t)result;
+    }
+    data.clear();
+    return true;
+}
+
+bool FileSink::close(std::string& error_msg) {
+    if (fd < 0) {
+        return true;
+    }
+    uv_fs_t req;
+    int result = uv_fs_close(nullptr, &req, fd, nullptr);
+    uv_fs_req_cleanup(&req);
+    fd = -1;
+    if (result < 0) {
+        error_msg = fsError("close", path, result);
+        return false;
+    }
+    return true;
+}
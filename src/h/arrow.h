@@ -0,0 +1,11 @@
+#pragma once
+#include "result_set.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Serializes fetched columns as an Apache Arrow IPC stream: a Schema
+// message, one RecordBatch message and the end-of-stream marker. Runs on
+// the worker thread; only reads the columns.
+bool writeArrowStream(const std::vector<ResultColumn>& columns, size_t row_count,
+                      std::string& out, std::string& error_msg);
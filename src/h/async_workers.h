@@ -3,53 +3,99 @@
 #include "napi.h"
 #include "connection.h"
 #include "stmt.h"
+#include "cursor.h"
+#include "lob.h"
 #include "execute_data.h"
+#include "result_set.h"
+#include "query_options.h"
+#include "export.h"
+#include "batch_params.h"
+#include "executor.h"
 #include <vector>
 #include <string>
-
-// --- Standalone Helper Function Declaration ---
-Napi::Value buildResult(Napi::Env env, a_sqlany_stmt* stmt);
+#include <memory>
 
 // --- Worker Classes ---
 class ConnectWorker;
 class NoParamsWorker;
 class ExecWorker;
+class ExportWorker;
 class PrepareWorker;
 class ExecStmtWorker;
+class ExecBatchWorker;
 class DropStmtWorker;
 class GetMoreResultsWorker;
+class CursorFetchWorker;
+class CursorCloseWorker;
+class CursorReleaseWorker;
+class LobReadWorker;
 
-class ExecWorker : public Napi::AsyncWorker {
+class ExecWorker : public ConnectionWorker {
 public:
-    ExecWorker(Connection* conn_obj, const Napi::Function& callback, std::string sql, Napi::Array params);
+    ExecWorker(Connection* conn_obj, const Napi::Function& callback, std::string sql, Napi::Array params, const QueryOptions& options);
     void Execute();
     void OnOK();
 private:
     // prepareBindParams is now a free function, so it's removed from here.
     Connection* conn_obj;
     std::string sql;
-    Napi::Value result;
+    QueryOptions options;
+    ResultSet results;
+    std::shared_ptr<CursorState> cursor_state;
+    std::string error_msg;
+    std::vector<a_sqlany_bind_param> bind_params;
+    ExecuteData param_data;
+};
+
+class ExportWorker : public ConnectionWorker {
+public:
+    ExportWorker(Connection* conn_obj, const Napi::Function& callback, std::string sql, Napi::Array params, const ExportOptions& options);
+    void Execute();
+    void OnOK();
+private:
+    bool writeRows(a_sqlany_stmt* stmt);
+
+    Connection* conn_obj;
+    std::string sql;
+    ExportOptions options;
+    uint64_t rows_written = 0;
     std::string error_msg;
-    a_sqlany_stmt* stmt_handle = nullptr;
     std::vector<a_sqlany_bind_param> bind_params;
     ExecuteData param_data;
 };
 
-class ExecStmtWorker : public Napi::AsyncWorker {
+class ExecStmtWorker : public ConnectionWorker {
 public:
-    ExecStmtWorker(StmtObject* stmt_obj, const Napi::Function& callback, Napi::Array params);
+    ExecStmtWorker(StmtObject* stmt_obj, const Napi::Function& callback, Napi::Array params, const QueryOptions& options);
     void Execute();
     void OnOK();
 private:
     // prepareBindParams is now a free function, so it's removed from here.
     StmtObject* stmt_obj;
-    Napi::Value result;
+    QueryOptions options;
+    ResultSet results;
+    unsigned int generation = 0;
     std::string error_msg;
+    // Values for the statement's described parameters, or else bind_params.
+    bool use_staged = false;
+    std::vector<StagedParam> staged;
     std::vector<a_sqlany_bind_param> bind_params;
     ExecuteData param_data;
 };
 
-class ConnectWorker : public Napi::AsyncWorker {
+class ExecBatchWorker : public ConnectionWorker {
+public:
+    ExecBatchWorker(StmtObject* stmt_obj, const Napi::Function& callback, BatchParams&& params);
+    void Execute();
+    void OnOK();
+private:
+    StmtObject* stmt_obj;
+    BatchParams params;
+    uint64_t affected_rows = 0;
+    std::string error_msg;
+};
+
+class ConnectWorker : public ConnectionWorker {
 public:
     ConnectWorker(Connection* conn_obj, const Napi::Function& callback, std::string conn_str);
     void Execute();
@@ -60,7 +106,7 @@ private:
     std::string error_msg;
 };
 
-class NoParamsWorker : public Napi::AsyncWorker {
+class NoParamsWorker : public ConnectionWorker {
 public:
     enum class Task { Commit, Rollback, Disconnect };
     NoParamsWorker(Connection* conn_obj, const Napi::Function& callback, Task task);
@@ -72,19 +118,23 @@ private:
     std::string error_msg;
 };
 
-class PrepareWorker : public Napi::AsyncWorker {
+class PrepareWorker : public ConnectionWorker {
 public:
-    PrepareWorker(Connection* conn_obj, const Napi::Function& callback, std::string sql);
+    PrepareWorker(Connection* conn_obj, const Napi::Function& callback, std::string sql,
+                  std::vector<a_sqlany_data_type> types);
     void Execute();
     void OnOK();
 private:
     Connection* conn_obj;
     std::string sql;
     a_sqlany_stmt* stmt_handle = nullptr;
+    // The `types` signature, empty when the statement is described instead.
+    std::vector<a_sqlany_data_type> types;
+    StmtParams params;
     std::string error_msg;
 };
 
-class DropStmtWorker : public Napi::AsyncWorker {
+class DropStmtWorker : public ConnectionWorker {
 public:
     DropStmtWorker(StmtObject* stmt_obj, const Napi::Function& callback);
     void Execute();
@@ -93,14 +143,67 @@ private:
     StmtObject* stmt_obj;
 };
 
-class GetMoreResultsWorker : public Napi::AsyncWorker {
+class GetMoreResultsWorker : public ConnectionWorker {
 public:
-    GetMoreResultsWorker(StmtObject* stmt_obj, const Napi::Function& callback);
+    GetMoreResultsWorker(StmtObject* stmt_obj, const Napi::Function& callback, const QueryOptions& options);
     void Execute();
     void OnOK();
 private:
     StmtObject* stmt_obj;
-    Napi::Value result;
+    QueryOptions options;
+    ResultSet results;
+    unsigned int generation = 0;
     std::string error_msg;
     bool has_more_results = false;
+};
+
+class CursorFetchWorker : public ConnectionWorker {
+public:
+    CursorFetchWorker(Cursor* cursor, const Napi::Function& callback, uint32_t max_rows);
+    void Execute();
+    void OnOK();
+private:
+    Cursor* cursor;
+    Connection* conn_obj;
+    std::shared_ptr<CursorState> state;
+    uint32_t max_rows;
+    ResultSet results;
+    bool open = false;
+    std::string error_msg;
+};
+
+class CursorCloseWorker : public ConnectionWorker {
+public:
+    CursorCloseWorker(Cursor* cursor, const Napi::Function& callback);
+    void Execute();
+    void OnOK();
+private:
+    Cursor* cursor;
+    Connection* conn_obj;
+    std::shared_ptr<CursorState> state;
+};
+
+// Frees the statement of a cursor that was garbage collected while open.
+class CursorReleaseWorker : public ConnectionWorker {
+public:
+    CursorReleaseWorker(Connection* conn_obj, Napi::Env env, std::shared_ptr<CursorState> state);
+    void Execute();
+    void OnOK();
+private:
+    Connection* conn_obj;
+    std::shared_ptr<CursorState> state;
+};
+
+class LobReadWorker : public ConnectionWorker {
+public:
+    LobReadWorker(Lob* lob, const Napi::Function& callback, size_t max_bytes);
+    void Execute();
+    void OnOK();
+private:
+    Lob* lob;
+    // Read on the main thread, where cursor->connection is kept.
+    Connection* conn_obj;
+    size_t max_bytes;
+    std::vector<char> chunk;
+    std::string error_msg;
 };
\ No newline at end of file
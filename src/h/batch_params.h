@@ -0,0 +1,59 @@
+#pragma once
+#include "napi.h"
+#include "sqlany_utils.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+// The parameter sets of one Statement.execBatch / execBatchColumns call,
+// encoded on the main thread into bind arrays and executed on the worker
+// thread. With API version 4 each chunk of rows is sent in a single
+// sqlany_execute through the wide insert API (sqlany_set_batch_size /
+// sqlany_set_param_bind_type); older client libraries execute the same
+// arrays one row at a time.
+class BatchParams {
+public:
+    // Encodes an array of parameter arrays row-wise. Every row must have the
+    // same length; each column is bound with one type that fits all of its
+    // values (numbers mixed with strings are sent as text).
+    bool fromRows(const Napi::Array& rows, std::string& error_msg);
+    // Binds an object of equally long columns column-wise, one parameter per
+    // property in order. Typed arrays are bound in place and kept alive until
+    // the batch is released (a Float32Array only from API version 5 on; it is
+    // widened into a double array for older clients); string arrays are
+    // encoded into one fixed-width array. `nulls` optionally maps column names to per-row NULL flags.
+    bool fromColumns(const Napi::Object& columns, const Napi::Value& nulls, std::string& error_msg);
+    // Binds and executes every chunk; must run with conn_mutex held.
+    bool execute(a_sqlany_stmt* stmt, a_sqlany_connection* conn, uint64_t& affected_rows, std::string& error_msg);
+
+private:
+    // One parameter's arrays as seen from the first row of a chunk. `length`
+    // and `is_null` may be NULL: fixed-width types need no lengths, and a
+    // column without NULLs needs no flags.
+    struct BoundColumn {
+        a_sqlany_data_type type;
+        size_t width;
+        char* value;
+        size_t* length;
+        sacapi_bool* is_null;
+    };
+    struct Chunk {
+        size_t rows = 0;
+        // Row-wise binding: the bytes from one row's struct to the next.
+        // 0 selects column-wise binding, where every array steps by its own
+        // element size.
+        size_t row_size = 0;
+        std::vector<BoundColumn> columns;
+        std::vector<char> data;
+    };
+
+    bool bindRow(a_sqlany_stmt* stmt, Chunk& chunk, size_t row);
+    char* own(size_t bytes);
+
+    std::vector<Chunk> chunks;
+    // Column-wise inputs: the typed arrays bound in place, and the arrays
+    // encoded for columns that cannot be.
+    std::vector<Napi::ObjectReference> pinned;
+    std::vector<std::unique_ptr<char[]>> storage;
+};
@@ -6,8 +6,12 @@
 #include "napi.h"
 #include "sqlany_utils.h"
 #include "stmt.h"
+#include "cursor.h"
+#include "query_options.h"
+#include "executor.h"
 #include <vector>
 #include <string>
+#include <memory>
 
 class Connection : public Napi::ObjectWrap<Connection> {
 public:
@@ -18,13 +22,25 @@ public:
     // Public properties
     a_sqlany_connection *conn;
     std::vector<StmtObject*> statements;
+    // Main thread: the open cursors, detached when the connection goes away.
+    std::vector<Cursor*> cursors;
+    // conn_mutex held: the cursors that own their statement, which is freed
+    // on disconnect.
+    std::vector<std::shared_ptr<CursorState>> cursor_states;
     uv_mutex_t conn_mutex;
     unsigned int max_api_ver;
     bool sqlca_connection;
     std::string _arg;
+    // Options every exec on this connection starts from.
+    QueryOptions defaults;
+    // Runs this connection's requests on its own thread.
+    Executor executor;
 
     // Public methods
     void removeStmt(StmtObject *stmt);
+    void removeCursor(Cursor *cursor);
+    void detachCursors();
+    void closeCursor(CursorState *state);
     void cleanupStmts();
 
 private:
@@ -34,6 +50,10 @@ private:
     Napi::Value Connect(const Napi::CallbackInfo& info);
     Napi::Value Disconnect(const Napi::CallbackInfo& info);
     Napi::Value Exec(const Napi::CallbackInfo& info);
+    Napi::Value QueryOne(const Napi::CallbackInfo& info);
+    Napi::Value QueryScalar(const Napi::CallbackInfo& info);
+    Napi::Value ExportToFile(const Napi::CallbackInfo& info);
+    Napi::Value queueExec(const Napi::CallbackInfo& info, const char* method, ResultShape shape);
     Napi::Value Prepare(const Napi::CallbackInfo& info);
     Napi::Value Commit(const Napi::CallbackInfo& info);
     Napi::Value Rollback(const Napi::CallbackInfo& info);
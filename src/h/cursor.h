@@ -0,0 +1,71 @@
+#pragma once
+#include <uv.h>
+#include "napi.h"
+#include "sqlany_utils.h"
+#include "result_set.h"
+#include "query_options.h"
+#include <memory>
+
+// Forward declare to avoid circular dependencies
+class Connection;
+class StmtObject;
+
+// The part of a cursor that its connection's thread reads and changes, only
+// with the connection's conn_mutex held. It is shared with the workers and,
+// for an owned statement, with the connection, so that a disconnect can free
+// the statement and a garbage collected cursor can leave it to the
+// connection's thread.
+struct CursorState {
+    // Worker thread, conn_mutex held: the statement to fetch from, or NULL
+    // with error_msg set when the cursor can no longer be read.
+    a_sqlany_stmt* statement(std::string& error_msg);
+    // conn_mutex held: free an owned statement and mark the cursor closed.
+    void close();
+
+    a_sqlany_stmt* owned_stmt = NULL;
+    StmtObject* stmt_obj = NULL;
+    unsigned int generation = 0;
+    bool closed = false;
+    // The position of the last row fetched, advanced by every row and every
+    // fetch past the end; a Lob compares it to the position its row was
+    // fetched at to tell whether the cursor is still on that row.
+    uint64_t position = 0;
+    // Rows handed out so far, checked against options.max_rows.
+    uint64_t rows_fetched = 0;
+};
+
+// An open result set that is fetched in batches. A cursor either owns its
+// statement handle (from Connection.exec) or borrows the handle of a prepared
+// Statement, in which case it is only valid until that statement is executed
+// again or dropped.
+class Cursor : public Napi::ObjectWrap<Cursor> {
+public:
+    static Napi::FunctionReference constructor;
+
+    static Napi::Object Init(Napi::Env env, Napi::Object exports);
+    Cursor(const Napi::CallbackInfo& info);
+    ~Cursor();
+
+    // Main thread: attach to the statement the cursor reads from. An owned
+    // statement's state has already been added to the connection's
+    // cursor_states by the worker that executed it.
+    void open(Connection* conn_obj, std::shared_ptr<CursorState> state, const ResultSet& layout, const QueryOptions& options);
+    void open(StmtObject* stmt_obj, unsigned int generation, const ResultSet& layout, const QueryOptions& options);
+    // Main thread: mark the cursor done and unregister it from the connection.
+    void detach();
+
+    // Public properties, main thread only except for `state`.
+    Connection* connection;
+    std::shared_ptr<CursorState> state;
+    ResultSet layout;
+    QueryOptions options;
+    bool done;
+
+private:
+    Napi::ObjectReference stmt_ref;
+
+    // N-API Wrapped Methods
+    Napi::Value Fetch(const Napi::CallbackInfo& info);
+    Napi::Value Close(const Napi::CallbackInfo& info);
+    Napi::Value Done(const Napi::CallbackInfo& info);
+};
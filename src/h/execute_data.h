@@ -1,34 +1,76 @@
 #pragma once
 #include <napi.h>
 #include "sacapi.h"
+#include "param_stream.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
 
-// A helper class to manage the lifetime of allocated memory for bind parameters,
-// mimicking the original driver's strategy. This prevents pointers
-// from becoming invalid when passed to the database client.
+// Owns the values, lengths and string bytes that bind parameters point to
+// for the life of one request, and keeps Buffer parameters alive so that
+// they can be bound in place. Everything is carved out of a bump arena: a
+// small inline block covers typical statements without touching the heap,
+// further blocks are chained as needed, and all of it is released at once
+// when the request completes. Memory handed out never moves, so pointers
+// stay valid while the database client reads them.
 class ExecuteData {
 public:
-    ~ExecuteData() {
-        for (auto p : int_vals) delete p;
-        for (auto p : ll_vals) delete p; // For 64-bit integers
-        for (auto p : double_vals) delete p;
-        for (auto p : string_vals) delete[] p;
-        for (auto p : len_vals) delete p;
+    ExecuteData() : next(inline_block), remaining(sizeof(inline_block)) {}
+    ExecuteData(const ExecuteData&) = delete;
+    ExecuteData& operator=(const ExecuteData&) = delete;
+
+    // Returns `size` bytes aligned to `align` (a power of two).
+    void* allocate(size_t size, size_t align) {
+        size_t pad = (align - (reinterpret_cast<uintptr_t>(next) & (align - 1))) & (align - 1);
+        if (pad + size > remaining) {
+            if (size > BLOCK_BYTES / 4) {
+                // Large values get a block of their own so the current one
+                // keeps serving small allocations.
+                blocks.emplace_back(new char[size]);
+                return blocks.back().get();
+            }
+            blocks.emplace_back(new char[BLOCK_BYTES]);
+            next = blocks.back().get();
+            remaining = BLOCK_BYTES;
+            pad = 0;
+        }
+        char* at = next + pad;
+        next = at + size;
+        remaining -= pad + size;
+        return at;
+    }
+
+    template <typename T> T* add(T value) {
+        T* at = static_cast<T*>(allocate(sizeof(T), alignof(T)));
+        *at = value;
+        return at;
     }
 
-    void addInt(int* val) { int_vals.push_back(val); }
-    void addLongLong(long long* val) { ll_vals.push_back(val); } // For 64-bit integers
-    void addDouble(double* val) { double_vals.push_back(val); }
-    void addString(char* str, size_t* len) {
-        string_vals.push_back(str);
-        len_vals.push_back(len);
+    // Copies `length` bytes and a terminating NUL.
+    char* addBytes(const char* data, size_t length) {
+        char* at = static_cast<char*>(allocate(length + 1, 1));
+        if (length > 0) { memcpy(at, data, length); }
+        at[length] = '\0';
+        return at;
     }
 
+    // Holds a reference to a Buffer whose memory is bound directly. Called on
+    // the main thread; the reference is dropped when the worker is deleted,
+    // which also happens on the main thread.
+    void pin(const Napi::Object& buffer) { pinned.push_back(Napi::Persistent(buffer)); }
+
+    // Parameters whose values are streamed after binding.
+    StreamParams streams;
+
 private:
-    std::vector<int*> int_vals;
-    std::vector<long long*> ll_vals; // For 64-bit integers
-    std::vector<double*> double_vals;
-    std::vector<char*> string_vals;
-    std::vector<size_t*> len_vals;
-};
\ No newline at end of file
+    static const size_t BLOCK_BYTES = 8192;
+
+    alignas(std::max_align_t) char inline_block[1024];
+    char* next;
+    size_t remaining;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<Napi::ObjectReference> pinned;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <uv.h>
+#include "napi.h"
+#include <deque>
+#include <string>
+
+class Connection;
+class ConnectionWorker;
+
+// A connection's own work thread. Requests on a connection run there one at
+// a time, in the order they were queued, instead of each occupying a libuv
+// threadpool thread while it waits for the connection; fs, dns and other
+// connections never compete with them for the pool. Completions are posted
+// back to the main thread through a thread-safe function. The thread starts
+// with the first request and is joined when the connection is destroyed.
+class Executor {
+public:
+    explicit Executor(Connection* owner);
+    ~Executor();
+    // Main thread: joins the thread and drops requests it has not started,
+    // so that nothing runs on it while the connection is torn down.
+    void stop();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Main thread. While requests are pending, the connection object stays
+    // alive and keeps the event loop running.
+    void submit(Napi::Env env, ConnectionWorker* worker);
+    // Main thread, once `worker` has completed.
+    void finished(Napi::Env env);
+
+private:
+    static void run(void* arg);
+
+    Connection* owner;
+    uv_thread_t thread;
+    bool started = false;
+    uv_mutex_t mutex;
+    uv_cond_t cond;
+    std::deque<ConnectionWorker*> queue;
+    bool stopping = false;
+    Napi::ThreadSafeFunction completions;
+    // Shared with the finalizer of `completions`, which at environment
+    // teardown may run before the executor is destroyed, or after it.
+    struct CompletionsState {
+        bool finalized = false;
+        bool orphaned = false;
+    };
+    CompletionsState* completions_state = nullptr;
+    // Main thread only.
+    size_t pending = 0;
+};
+
+// An AsyncWorker that runs on its connection's Executor. Execute and OnOK
+// keep their AsyncWorker meaning; a worker whose connection is already gone
+// (a dropped statement, a detached cursor) runs on the libuv threadpool as
+// before.
+class ConnectionWorker : public Napi::AsyncWorker {
+public:
+    void Queue();
+
+protected:
+    // Hides AsyncWorker::SetError so that a failure is reported through
+    // OnError on the executor too, which cannot read AsyncWorker's error.
+    void SetError(const std::string& error);
+
+protected:
+    ConnectionWorker(Connection* connection, const Napi::Function& callback)
+        : Napi::AsyncWorker(callback), connection(connection) {}
+    ConnectionWorker(Connection* connection, const Napi::Object& receiver, const Napi::Function& callback)
+        : Napi::AsyncWorker(receiver, callback), connection(connection) {}
+    // A worker without a callback, for clean-up that nothing waits for.
+    ConnectionWorker(Connection* connection, Napi::Env env)
+        : Napi::AsyncWorker(env), connection(connection) {}
+
+private:
+    friend class Executor;
+    // Main thread: delivers the result and deletes the worker.
+    void complete(Napi::Env env);
+    // Main thread: deletes a worker that never ran.
+    void discard() { Destroy(); }
+
+    Connection* connection;
+    std::string error;
+    Executor* executor = nullptr;
+};
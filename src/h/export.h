@@ -0,0 +1,57 @@
+#pragma once
+#include <uv.h>
+#include "napi.h"
+#include "result_set.h"
+#include <vector>
+#include <string>
+
+// Text encodings of fetched rows. They only read the columns, so they run on
+// the worker thread and no row ever becomes a JavaScript value.
+enum class TextFormat { Csv, Ndjson };
+
+// RFC 4180 CSV: NULL is an empty field, an empty string is "", binary values
+// are hex encoded. Rows end with CRLF.
+void appendCsvHeader(std::string& out, const std::vector<ResultColumn>& columns);
+void appendCsvRows(std::string& out, const std::vector<ResultColumn>& columns, size_t rows);
+
+// How appendJsonRows writes values that JSON has no type for. The defaults
+// are exact; format 'json' instead mirrors JSON.stringify of object rows.
+struct JsonStyle {
+    // BigInt writes BIGINT values as exact integer literals, Number rounds
+    // them to doubles and String quotes them.
+    Int64Mode int64 = Int64Mode::BigInt;
+    // Parsed DATE / TIMESTAMP values: ISO 8601 strings with Date, else epoch
+    // milliseconds.
+    DateMode dates = DateMode::Epoch;
+    // Binary values as Buffer.toJSON() objects rather than hex strings.
+    bool buffer_objects = false;
+};
+
+// One JSON object per row keyed by column name, each followed by `terminator`.
+void appendJsonRows(std::string& out, const std::vector<ResultColumn>& columns, size_t rows, char terminator,
+                    const JsonStyle& style = JsonStyle());
+
+// Options of connection.exportToFile.
+struct ExportOptions {
+    TextFormat format = TextFormat::Csv;
+    std::string path;
+    // CSV only: write the column names as the first line.
+    bool header = true;
+};
+
+bool parseExportOptions(const Napi::Value& value, ExportOptions& options, std::string& error_msg);
+
+// A file written with synchronous libuv calls from the worker thread. The
+// file is created or truncated by open and closed by close or the destructor.
+class FileSink {
+public:
+    ~FileSink();
+    bool open(const std::string& path, std::string& error_msg);
+    // Writes all of `data`, then empties it.
+    bool write(std::string& data, std::string& error_msg);
+    bool close(std::string& error_msg);
+
+private:
+    uv_file fd = -1;
+    std::string path;
+};
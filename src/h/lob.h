@@ -0,0 +1,38 @@
+#pragma once
+#include <uv.h>
+#include "napi.h"
+#include "sqlany_utils.h"
+
+class Cursor;
+class Connection;
+
+// A LONG BINARY / LONG VARCHAR value of the row a cursor is positioned on,
+// read in chunks with sqlany_get_data instead of being fetched as a whole.
+// It is only readable until the cursor fetches again or is closed.
+class Lob : public Napi::ObjectWrap<Lob> {
+public:
+    static Napi::FunctionReference constructor;
+
+    static Napi::Object Init(Napi::Env env, Napi::Object exports);
+    // Main thread: the JavaScript value handed out for a streamed LOB cell
+    // of the row the cursor fetched at `position`.
+    static Napi::Value New(Cursor* cursor, sacapi_u32 column, uint64_t size, uint64_t position);
+    Lob(const Napi::CallbackInfo& info);
+
+    // Worker thread: reads the next chunk of at most max_bytes into chunk.
+    // conn_obj is the cursor's connection when the read was queued, or NULL.
+    bool readChunk(Connection* conn_obj, size_t max_bytes, std::vector<char>& chunk, std::string& error_msg);
+
+    Cursor* cursor;
+    sacapi_u32 column;
+    uint64_t size;
+    uint64_t offset;
+
+private:
+    Napi::ObjectReference cursor_ref;
+    uint64_t position;
+
+    // N-API Wrapped Methods
+    Napi::Value Read(const Napi::CallbackInfo& info);
+    Napi::Value Size(const Napi::CallbackInfo& info);
+};
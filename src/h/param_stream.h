@@ -0,0 +1,85 @@
+#pragma once
+#include <uv.h>
+#include "napi.h"
+#include "sqlany_utils.h"
+#include <deque>
+#include <vector>
+#include <string>
+
+// A parameter value read from a Readable stream or async iterable. index.js
+// pumps the source into write() on the main thread; the worker executing
+// the statement takes the chunks in order and hands them to
+// sqlany_send_param_data, so only a few chunks are held at any time. A
+// writer that fills the queue waits until the worker has taken a chunk.
+class ParamStream : public Napi::ObjectWrap<ParamStream> {
+public:
+    static Napi::FunctionReference constructor;
+
+    static Napi::Object Init(Napi::Env env, Napi::Object exports);
+    // Main thread: whether `val` should be sent as a stream parameter.
+    static bool IsSource(const Napi::Value& val);
+    // Main thread: a stream that starts pumping `source`.
+    static ParamStream* New(const Napi::Value& source);
+    ParamStream(const Napi::CallbackInfo& info);
+    ~ParamStream();
+
+    // Worker thread: waits for the next chunk. Returns false at the end of
+    // the source (done set) or when it failed (error_msg set).
+    bool next(std::string& chunk, bool& text, bool& done, std::string& error_msg);
+    // Main thread: the statement no longer reads the stream. Pending and
+    // later writes fail so that the pump stops.
+    void close();
+
+private:
+    struct Chunk {
+        std::string data;
+        bool text;
+    };
+
+    uv_mutex_t mutex;
+    uv_cond_t cond;
+    std::deque<Chunk> queue;
+    bool ended = false;
+    bool closed = false;
+    std::string error;
+    // Set while the writer waits for room in the queue; the worker then
+    // wakes it on the main thread through `wake`.
+    bool writer_waiting = false;
+    Napi::FunctionReference waiting_callback;
+    Napi::ThreadSafeFunction wake;
+    bool has_wake = false;
+
+    void resumeWriter(Napi::Env env, const char* error_msg);
+    void fail(const std::string& message);
+
+    // N-API Wrapped Methods
+    Napi::Value Write(const Napi::CallbackInfo& info);
+    Napi::Value End(const Napi::CallbackInfo& info);
+    Napi::Value Fail(const Napi::CallbackInfo& info);
+};
+
+// The stream parameters of one request, in parameter order.
+class StreamParams {
+public:
+    StreamParams() = default;
+    StreamParams(const StreamParams&) = delete;
+    StreamParams& operator=(const StreamParams&) = delete;
+    // Closes every stream; runs on the main thread with the worker's deletion.
+    ~StreamParams();
+
+    // Main thread; keeps the stream referenced until the request completes.
+    void add(sacapi_u32 index, ParamStream* stream);
+    bool empty() const { return streams.empty(); }
+    // Worker thread, with conn_mutex held, after the other parameters are
+    // bound and before sqlany_execute: binds each stream parameter and sends
+    // its chunks.
+    bool send(a_sqlany_stmt* stmt, a_sqlany_connection* conn, std::string& error_msg);
+
+private:
+    struct Entry {
+        sacapi_u32 index;
+        ParamStream* stream;
+        Napi::ObjectReference ref;
+    };
+    std::vector<Entry> streams;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include "napi.h"
+#include <string>
+#include <cstdint>
+
+// Shape of the rows handed back to JavaScript.
+enum class RowMode { Object, Array, Columnar };
+
+// JavaScript type of BIGINT / UNSIGNED BIGINT values in row results.
+enum class Int64Mode { Number, BigInt, String };
+
+// What exec hands back: every row, only the first row (queryOne) or only the
+// first column of the first row (queryScalar).
+enum class ResultShape { Rows, FirstRow, Scalar };
+
+// JavaScript type of DATE and TIMESTAMP values.
+enum class DateMode { String, Date, Epoch };
+
+// Encoding of a fetched result: JavaScript rows (as chosen by RowMode), or a
+// Buffer built on the worker thread holding an Apache Arrow IPC stream or the
+// UTF-8 JSON text of the rows.
+enum class OutputFormat { Rows, Arrow, Json };
+
+// Per-call options accepted by exec, Statement.exec and getMoreResults. A
+// connection's defaults (see the Connection constructor) are applied first.
+struct QueryOptions {
+    RowMode row_mode = RowMode::Object;
+    // Return a Cursor instead of fetching the whole result set.
+    bool cursor = false;
+    // Rows per Cursor.fetch() call when no count is given.
+    uint32_t fetch_size = 1000;
+    // Stop fetching after this many rows; 0 means no limit.
+    uint64_t max_rows = 0;
+    ResultShape shape = ResultShape::Rows;
+    // Return LONG BINARY / LONG VARCHAR cells as streams (cursors only).
+    bool stream_lobs = false;
+    Int64Mode int64 = Int64Mode::Number;
+    DateMode dates = DateMode::String;
+    // Create one JavaScript string per distinct value of each string column.
+    bool intern_strings = false;
+    OutputFormat format = OutputFormat::Rows;
+};
+
+bool parseQueryOptions(const Napi::Value& value, QueryOptions& options, std::string& error_msg);
+
+// queryOne / queryScalar: fetch at most one row, never open a cursor and
+// always return JavaScript values.
+void applyResultShape(QueryOptions& options, ResultShape shape);
+
+// Splits the optional arguments found between the fixed leading arguments and
+// the trailing callback into a parameter array and an options object.
+bool parseExecArgs(const Napi::CallbackInfo& info, size_t begin, size_t end, const char* method,
+                   Napi::Array& params, QueryOptions& options, std::string& error_msg);
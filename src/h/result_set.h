@@ -0,0 +1,115 @@
+#pragma once
+#include "napi.h"
+#include "sacapi.h"
+#include "query_options.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// How a column's values are held in native memory. Narrow integer types are
+// widened on fetch so that each column needs only one storage layout.
+enum class ColumnStorage { Int32, Uint32, Int64, Uint64, Double, String, Binary, Timestamp, Lob, Unsupported };
+
+// The values of one result set column, captured on the worker thread.
+// Fixed-width values are packed into `fixed`; strings and binaries are
+// appended to `data` and addressed through `offsets` (rows + 1 entries).
+// Streamed LOB columns only record each value's length in `fixed`. Parsed
+// DATE / TIMESTAMP columns hold epoch milliseconds in `fixed`, or NaN with
+// the original text in `data` when a value could not be parsed; for format
+// 'arrow' they hold wall-clock microseconds (parseWallClock) instead, or
+// ARROW_INVALID_TIMESTAMP.
+static const int64_t ARROW_INVALID_TIMESTAMP = INT64_MIN;
+
+struct ResultColumn {
+    std::string name;
+    a_sqlany_data_type type;
+    a_sqlany_native_type native_type;
+    ColumnStorage storage;
+    std::vector<char> fixed;
+    std::vector<uint32_t> offsets;
+    std::vector<char> data;
+    std::vector<uint8_t> null_bits;
+    // String columns: bit set when the cell is pure ASCII, laid out like null_bits.
+    std::vector<uint8_t> ascii_bits;
+    // With internStrings: the dictionary code of each row, and for each code
+    // the first row holding that value.
+    std::vector<uint32_t> dict_codes;
+    std::vector<uint32_t> dict_rows;
+    size_t max_size;
+    bool nullable;
+
+    bool isNull(size_t row) const { return (null_bits[row >> 3] >> (row & 7)) & 1; }
+    template <typename T> T fixedAt(size_t row) const { return reinterpret_cast<const T*>(fixed.data())[row]; }
+};
+
+// A fully fetched result set. `fetch` drains the cursor into native buffers
+// and must run on the worker thread while conn_mutex is held; `toJS` only
+// converts that memory into JavaScript values and runs on the main thread.
+// `toJS` hands the column buffers of columnar results, the binary data of
+// row results and encoded Arrow / JSON output over to JavaScript, so it may
+// only be called once.
+class ResultSet {
+public:
+    // describe + fetchRows until the cursor is drained, or until
+    // options.max_rows rows have been read.
+    bool fetch(a_sqlany_stmt* stmt, a_sqlany_connection* conn, std::string& error_msg, const QueryOptions& options);
+    // Reads the column layout of the current result set without fetching rows.
+    // With stream_lobs, long columns are left on the server and fetched one
+    // row per batch so that a Lob can read them while the row is current.
+    bool describe(a_sqlany_stmt* stmt, a_sqlany_connection* conn, std::string& error_msg, const QueryOptions& options);
+    // Appends up to max_rows rows; sets exhausted once the cursor is drained.
+    // With format 'arrow' or 'json' the rows are then encoded into a Buffer.
+    bool fetchRows(a_sqlany_stmt* stmt, a_sqlany_connection* conn, size_t max_rows, std::string& error_msg);
+    Napi::Value toJS(Napi::Env env, const QueryOptions& options);
+
+    bool hasColumns() const { return has_columns; }
+    bool isExhausted() const { return exhausted; }
+    size_t rowCount() const { return row_count; }
+    // The fetched values, for encoders that run on the worker thread.
+    const std::vector<ResultColumn>& columnData() const { return columns; }
+
+    // Builds the JavaScript value of a streamed LOB cell; set before toJS.
+    // `position` is the cursor position the cell's row was fetched at.
+    std::function<Napi::Value(Napi::Env, sacapi_u32 column, uint64_t size, uint64_t position)> lob_value;
+    // Cursor position of the first row fetched, set on the worker thread;
+    // row r was fetched at first_position + r.
+    uint64_t first_position = 0;
+
+private:
+    bool fetchRowsWide(a_sqlany_stmt* stmt, a_sqlany_connection* conn, size_t max_rows, size_t rowset_rows, std::string& error_msg);
+    bool fetchRowsSingle(a_sqlany_stmt* stmt, a_sqlany_connection* conn, size_t max_rows, std::string& error_msg);
+    size_t wideRowsetRows() const;
+    bool appendValue(ResultColumn& col, const a_sqlany_data_value& val, size_t row);
+    Napi::Value stringToJS(Napi::Env env, const ResultColumn& col, size_t row) const;
+    Napi::Value cellToJS(Napi::Env env, const ResultColumn& col, size_t row) const;
+    Napi::Array columnsToJS(Napi::Env env) const;
+    Napi::Value rowsToObjects(Napi::Env env) const;
+    Napi::Value rowsToArrays(Napi::Env env) const;
+    Napi::Value firstRowToJS(Napi::Env env, bool as_array) const;
+    Napi::Value columnsToTypedArrays(Napi::Env env);
+    bool encode(std::string& error_msg);
+    Napi::Value encodedToJS(Napi::Env env);
+    void shareBinaryData(Napi::Env env);
+    void buildDictionaries();
+    void dictionariesToJS(Napi::Env env);
+
+    bool has_columns = false;
+    bool exhausted = false;
+    bool has_lobs = false;
+    bool intern_strings = false;
+    OutputFormat format = OutputFormat::Rows;
+    int affected_rows = 0;
+    size_t row_count = 0;
+    std::vector<ResultColumn> columns;
+    // Set by shareBinaryData: one ArrayBuffer per binary column (NULL for
+    // other columns) and Buffer.from, used to create each cell as a view.
+    std::vector<napi_value> binary_slabs;
+    napi_value buffer_from = nullptr;
+    Int64Mode int64_mode = Int64Mode::Number;
+    DateMode date_mode = DateMode::String;
+    // Set by dictionariesToJS: the string of each dictionary code, per column.
+    std::vector<std::vector<napi_value>> dict_values;
+    // With format 'arrow' or 'json': the bytes written by encode.
+    std::string encoded;
+};
@@ -17,6 +17,7 @@ class StmtObject;
 // Global API interface, defined in sqlanywhere.cpp
 extern SQLAnywhereInterface api;
 extern unsigned openConnections;
+extern sacapi_u32 apiVersion;
 extern uv_mutex_t api_mutex;
 
 // Utility functions
@@ -24,4 +25,6 @@ void getErrorMsg(int code, std::string &str);
 void getErrorMsg(a_sqlany_connection *conn, std::string &str);
 void throwNapiError(Napi::Env env, const std::string& message);
 void throwNapiError(Napi::Env env, int code);
-void throwNapiError(Napi::Env env, a_sqlany_connection *conn);
\ No newline at end of file
+void throwNapiError(Napi::Env env, a_sqlany_connection *conn);
+// For arguments of the wrong type or out of range, such as invalid options.
+void throwNapiTypeError(Napi::Env env, const std::string& message);
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <uv.h>
 #include "napi.h"
 #include "sqlany_utils.h"
+#include "query_options.h"
+#include "stmt_params.h"
 
 // Forward declare Connection to avoid circular dependency
 class Connection;
@@ -24,10 +26,20 @@ public:
     // Public properties
     Connection *connection;
     a_sqlany_stmt *sqlany_stmt;
+    // Bumped whenever the statement starts a new result set, so that cursors
+    // over an earlier result set can tell they have gone stale.
+    unsigned int generation;
+    // Parameter descriptors and bind buffers reused by every exec.
+    StmtParams params;
 
 private:
     // N-API Wrapped Methods
     Napi::Value Exec(const Napi::CallbackInfo& info);
+    Napi::Value QueryOne(const Napi::CallbackInfo& info);
+    Napi::Value QueryScalar(const Napi::CallbackInfo& info);
+    Napi::Value queueExec(const Napi::CallbackInfo& info, const char* method, ResultShape shape);
+    Napi::Value ExecBatch(const Napi::CallbackInfo& info);
+    Napi::Value ExecBatchColumns(const Napi::CallbackInfo& info);
     Napi::Value Drop(const Napi::CallbackInfo& info);
     Napi::Value GetMoreResults(const Napi::CallbackInfo& info);
 };
\ No newline at end of file
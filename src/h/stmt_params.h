@@ -0,0 +1,88 @@
+#pragma once
+#include "napi.h"
+#include "sqlany_utils.h"
+#include "execute_data.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Binds one JavaScript value, parameter `index`, the way Statement.exec
+// always has, guessing its type from the value. Defined with
+// prepareBindParams in async_workers.cpp.
+void bindParamValue(const Napi::Value& val, uint32_t index, a_sqlany_bind_param& p, ExecuteData& param_data);
+
+// Parses the `types` option of connection.prepare: one of 'int8', 'uint8',
+// 'int16', 'uint16', 'int32', 'uint32', 'int64', 'uint64', 'float',
+// 'double', 'string' or 'binary' per parameter.
+bool parseParamTypes(const Napi::Value& value, std::vector<a_sqlany_data_type>& types, std::string& error_msg);
+
+// One execution's value for a described parameter, converted to that
+// parameter's type on the main thread.
+struct StagedParam {
+    bool is_null = false;
+    // Set for values that do not fit the described type; they are bound
+    // from `bind` for this execution instead of through the slot.
+    bool generic = false;
+    a_sqlany_bind_param bind;
+    // A_STRING / A_BINARY slots: the bytes, kept in the request's arena or
+    // in a Buffer it pins.
+    const char* bytes = nullptr;
+    size_t length = 0;
+    // Fixed-width slots: the value in the slot's native representation.
+    alignas(8) char fixed[8];
+};
+
+// The parameters of a prepared statement, described once when it is
+// prepared. Fixed-width parameters are bound to buffers that live as long as
+// the statement: an execution whose values fit the described types only
+// copies them into those buffers and calls sqlany_execute, and
+// sqlany_bind_param runs again only for a parameter that was bound
+// differently in between (a value of another type, or execBatch). Strings
+// and Buffers are bound where stage() left them, in the request's arena or
+// the Buffer itself, and so bind with every execution.
+//
+// With a `types` signature given to connection.prepare, the slots take the
+// hinted types instead and every value is converted to its slot's type
+// without inspecting it further, the way a typed array stores numbers; a
+// value of the wrong kind is an error rather than a different binding.
+class StmtParams {
+public:
+    // Runs on the worker thread with conn_mutex held, right after
+    // sqlany_prepare. Without `hints`, statements the client cannot describe
+    // keep binding every value per execution. Fails when `hints` does not
+    // match the statement's parameter count.
+    bool describe(a_sqlany_stmt* stmt, const std::vector<a_sqlany_data_type>& hints, std::string& error_msg);
+    // Whether `values` go through stage(): the statement was described and
+    // one value is given per parameter, or it has a type signature.
+    bool fits(const Napi::Array& values) const {
+        return hinted || (described && values.Length() == slots.size());
+    }
+    // Main thread. Only reads the slot types, so it may run while an earlier
+    // execution is applying its values. Fails only for hinted statements.
+    bool stage(const Napi::Array& values, ExecuteData& param_data, std::vector<StagedParam>& staged,
+               std::string& error_msg) const;
+    // Worker thread, with conn_mutex held.
+    bool apply(a_sqlany_stmt* stmt, const std::vector<StagedParam>& staged);
+    // Worker thread, with conn_mutex held: the statement's parameters were
+    // bound to other buffers, so every slot binds again on next use.
+    void invalidate();
+
+private:
+    struct Slot {
+        // A_INVALID_TYPE for parameters that always take the generic path.
+        a_sqlany_data_type type = A_INVALID_TYPE;
+        size_t width = 0;
+        alignas(8) char fixed[8];
+        size_t length = 0;
+        sacapi_bool is_null = 0;
+        bool bound = false;
+    };
+
+    static bool bindSlot(a_sqlany_stmt* stmt, sacapi_u32 index, Slot& slot, char* buffer, size_t size);
+
+    bool described = false;
+    bool hinted = false;
+    // Bound buffers point into the slots, so the vector is sized once by
+    // describe and never resized (moving it keeps its storage).
+    std::vector<Slot> slots;
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Parses a DATE or TIMESTAMP value in the server's default ISO layout,
+// `YYYY-MM-DD[( |T)HH:NN[:SS[.fffffffff]]][Z|(+|-)HH[:NN]]`, into
+// whole milliseconds since the Unix epoch. As with Date, a date-time
+// without an offset is local time and a bare date is UTC. Returns false for
+// anything else (e.g. a custom date_format).
+bool parseTimestamp(const char* text, size_t length, double& epoch_ms);
+
+// Parses the same layout into microseconds since 1970-01-01 00:00 of the
+// wall-clock time as written, independent of the host's time zone; a value
+// with an offset is shifted to UTC. Used for Arrow's naive timestamps.
+bool parseWallClock(const char* text, size_t length, int64_t& micros);
+
+// Formats milliseconds since the Unix epoch the way Date.prototype.toJSON
+// does, `YYYY-MM-DDTHH:NN:SS.sssZ` (years outside 0-9999 as +/-YYYYYY).
+// `out` must hold at least 32 bytes; returns the length written.
+size_t formatTimestamp(double epoch_ms, char* out);
@@ -0,0 +1,101 @@
+#include "h/lob.h"
+#include "h/cursor.h"
+#include "h/connection.h"
+#include "h/async_workers.h"
+#include <algorithm>
+
+Napi::FunctionReference Lob::constructor;
+
+// Chunk bounds for Lob.read(); the stream wrapper asks for its highWaterMark.
+static const size_t LOB_MIN_CHUNK = 4 * 1024;
+static const size_t LOB_MAX_CHUNK = 1024 * 1024;
+
+Napi::Object Lob::Init(Napi::Env env, Napi::Object exports) {
+    Napi::HandleScope scope(env);
+    Napi::Function func = DefineClass(env, "Lob", {
+        InstanceMethod("read", &Lob::Read),
+        InstanceAccessor("size", &Lob::Size, nullptr),
+    });
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+    exports.Set("Lob", func);
+    return exports;
+}
+
+Lob::Lob(const Napi::CallbackInfo& info) : Napi::ObjectWrap<Lob>(info) {
+    this->cursor = NULL;
+    this->column = 0;
+    this->size = 0;
+    this->offset = 0;
+    this->position = 0;
+}
+
+Napi::Value Lob::New(Cursor* cursor, sacapi_u32 column, uint64_t size, uint64_t position) {
+    Napi::Object obj = constructor.New({});
+    Lob* lob = Lob::Unwrap(obj);
+    lob->cursor = cursor;
+    lob->cursor_ref = Napi::Persistent(cursor->Value());
+    lob->column = column;
+    lob->size = size;
+    lob->position = position;
+
+    // index.js wraps the handle in a Readable; without it, hand out the raw handle.
+    Napi::Value stream = obj.Get("stream");
+    if (stream.IsFunction()) {
+        return stream.As<Napi::Function>().Call(obj, {});
+    }
+    return obj;
+}
+
+bool Lob::readChunk(Connection* conn_obj, size_t max_bytes, std::vector<char>& chunk, std::string& error_msg) {
+    if (!conn_obj) {
+        error_msg = "LOB is no longer available: the cursor has been closed.";
+        return false;
+    }
+    uv_mutex_lock(&conn_obj->conn_mutex);
+    a_sqlany_stmt* stmt = NULL;
+    CursorState* state = this->cursor->state.get();
+    if (state->closed) {
+        error_msg = "LOB is no longer available: the cursor has been closed.";
+    } else if (state->position != this->position) {
+        error_msg = "LOB is no longer available: the cursor has moved to another row.";
+    } else {
+        stmt = state->statement(error_msg);
+    }
+    bool ok = stmt != NULL;
+    if (ok && this->offset < this->size) {
+        size_t want = (size_t)std::min<uint64_t>(std::min(std::max(max_bytes, LOB_MIN_CHUNK), LOB_MAX_CHUNK),
+                                                 this->size - this->offset);
+        chunk.resize(want);
+        sacapi_i32 got = api.sqlany_get_data(stmt, this->column, (size_t)this->offset, chunk.data(), want);
+        if (got < 0) {
+            getErrorMsg(conn_obj->conn, error_msg);
+            ok = false;
+        } else {
+            chunk.resize((size_t)got);
+            this->offset += (uint64_t)got;
+            // The reported size can be an estimate; stop once the server has no more data.
+            if (got == 0) { this->offset = this->size; }
+        }
+    }
+    uv_mutex_unlock(&conn_obj->conn_mutex);
+    return ok;
+}
+
+Napi::Value Lob::Read(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[info.Length() - 1].IsFunction()) {
+        throwNapiError(env, "Lob.read requires a callback function.");
+        return env.Undefined();
+    }
+    size_t max_bytes = LOB_MAX_CHUNK;
+    if (info.Length() > 1 && info[0].IsNumber() && info[0].As<Napi::Number>().DoubleValue() > 0) {
+        max_bytes = (size_t)info[0].As<Napi::Number>().DoubleValue();
+    }
+    (new LobReadWorker(this, info[info.Length() - 1].As<Napi::Function>(), max_bytes))->Queue();
+    return env.Undefined();
+}
+
+Napi::Value Lob::Size(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), (double)this->size);
+}
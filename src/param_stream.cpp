@@ -0,0 +1,251 @@
+#include "h/param_stream.h"
+#include <cstring>
+
+Napi::FunctionReference ParamStream::constructor;
+
+// Chunks a stream may run ahead of the worker before its writer waits.
+static const size_t PARAM_STREAM_MAX_QUEUED = 4;
+
+Napi::Object ParamStream::Init(Napi::Env env, Napi::Object exports) {
+    Napi::HandleScope scope(env);
+    Napi::Function func = DefineClass(env, "ParamStream", {
+        InstanceMethod("write", &ParamStream::Write),
+        InstanceMethod("end", &ParamStream::End),
+        InstanceMethod("fail", &ParamStream::Fail),
+    });
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+    exports.Set("ParamStream", func);
+    return exports;
+}
+
+ParamStream::ParamStream(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ParamStream>(info) {
+    uv_mutex_init(&mutex);
+    uv_cond_init(&cond);
+}
+
+ParamStream::~ParamStream() {
+    uv_cond_destroy(&cond);
+    uv_mutex_destroy(&mutex);
+}
+
+bool ParamStream::IsSource(const Napi::Value& val) {
+    if (!val.IsObject() || val.IsBuffer() || val.IsArray() || val.IsTypedArray()) {
+        return false;
+    }
+    Napi::Value iterator = val.As<Napi::Object>().Get(Napi::Symbol::WellKnown(val.Env(), "asyncIterator"));
+    return iterator.IsFunction();
+}
+
+ParamStream* ParamStream::New(const Napi::Value& source) {
+    Napi::Object obj = constructor.New({});
+    ParamStream* stream = ParamStream::Unwrap(obj);
+    // index.js supplies the pump that iterates the source.
+    Napi::Value pump = obj.Get("pump");
+    if (pump.IsFunction()) {
+        pump.As<Napi::Function>().Call(obj, {source});
+    } else {
+        stream->fail("Stream parameters need the module's index.js.");
+    }
+    return stream;
+}
+
+void ParamStream::fail(const std::string& message) {
+    uv_mutex_lock(&mutex);
+    if (!ended && error.empty()) {
+        error = message.empty() ? "Stream parameter failed." : message;
+    }
+    uv_cond_signal(&cond);
+    uv_mutex_unlock(&mutex);
+}
+
+// Main thread: calls the waiting writer back, with an error once closed.
+void ParamStream::resumeWriter(Napi::Env env, const char* error_msg) {
+    if (waiting_callback.IsEmpty()) {
+        return;
+    }
+    Napi::Function callback = waiting_callback.Value();
+    waiting_callback.Reset();
+    if (error_msg) {
+        callback.Call({Napi::Error::New(env, error_msg).Value()});
+    } else {
+        callback.Call({});
+    }
+}
+
+Napi::Value ParamStream::Write(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[1].IsFunction()) {
+        throwNapiError(env, "Invalid arguments for ParamStream.write: expecting (chunk, callback).");
+        return env.Undefined();
+    }
+    Napi::Function callback = info[1].As<Napi::Function>();
+    Chunk chunk;
+    if (info[0].IsString()) {
+        chunk.data = info[0].As<Napi::String>().Utf8Value();
+        chunk.text = true;
+    } else if (info[0].IsTypedArray()) {
+        Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+        const char* data = static_cast<const char*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+        chunk.data.assign(data, array.ByteLength());
+        chunk.text = false;
+    } else {
+        callback.Call({Napi::Error::New(env, "Stream parameters must yield Buffers or strings.").Value()});
+        return env.Undefined();
+    }
+
+    uv_mutex_lock(&mutex);
+    bool was_closed = closed;
+    bool full = false;
+    if (!closed) {
+        queue.push_back(std::move(chunk));
+        full = queue.size() >= PARAM_STREAM_MAX_QUEUED;
+        if (full) {
+            if (!has_wake) {
+                // Keeps this object alive until the wake function is finalized,
+                // which is after its last queued call has run.
+                Ref();
+                wake = Napi::ThreadSafeFunction::New(env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+                                                     "ParamStream", 0, 1, [this](Napi::Env) { Unref(); });
+                has_wake = true;
+            }
+            waiting_callback = Napi::Persistent(callback);
+            writer_waiting = true;
+        }
+        uv_cond_signal(&cond);
+    }
+    uv_mutex_unlock(&mutex);
+
+    if (was_closed) {
+        callback.Call({Napi::Error::New(env, "The statement no longer reads this stream.").Value()});
+    } else if (!full) {
+        callback.Call({});
+    }
+    return env.Undefined();
+}
+
+Napi::Value ParamStream::End(const Napi::CallbackInfo& info) {
+    uv_mutex_lock(&mutex);
+    ended = error.empty();
+    uv_cond_signal(&cond);
+    uv_mutex_unlock(&mutex);
+    return info.Env().Undefined();
+}
+
+Napi::Value ParamStream::Fail(const Napi::CallbackInfo& info) {
+    fail(info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value() : "");
+    return info.Env().Undefined();
+}
+
+bool ParamStream::next(std::string& chunk, bool& text, bool& done, std::string& error_msg) {
+    done = false;
+    uv_mutex_lock(&mutex);
+    while (queue.empty() && !ended && error.empty()) {
+        uv_cond_wait(&cond, &mutex);
+    }
+    bool ok = true;
+    bool resume = false;
+    if (!queue.empty()) {
+        chunk.swap(queue.front().data);
+        text = queue.front().text;
+        queue.pop_front();
+        resume = writer_waiting;
+        writer_waiting = false;
+    } else if (!error.empty()) {
+        error_msg = error;
+        ok = false;
+    } else {
+        done = true;
+    }
+    uv_mutex_unlock(&mutex);
+    if (resume) {
+        wake.BlockingCall([this](Napi::Env env, Napi::Function) { resumeWriter(env, nullptr); });
+    }
+    return ok && !done;
+}
+
+void ParamStream::close() {
+    uv_mutex_lock(&mutex);
+    closed = true;
+    queue.clear();
+    writer_waiting = false;
+    uv_mutex_unlock(&mutex);
+    resumeWriter(Env(), "The statement no longer reads this stream.");
+    if (has_wake) {
+        wake.Release();
+        has_wake = false;
+    }
+}
+
+void StreamParams::add(sacapi_u32 index, ParamStream* stream) {
+    streams.push_back({index, stream, Napi::Persistent(stream->Value())});
+}
+
+StreamParams::~StreamParams() {
+    for (Entry& entry : streams) {
+        entry.stream->close();
+    }
+}
+
+// Binds a stream parameter without a buffer: its value is sent afterwards.
+static bool bindStream(a_sqlany_stmt* stmt, a_sqlany_connection* conn, sacapi_u32 index,
+                       a_sqlany_data_type type, std::string& error_msg) {
+    a_sqlany_bind_param p;
+    memset(&p, 0, sizeof(p));
+    p.direction = DD_INPUT;
+    p.value.type = type;
+    if (!api.sqlany_bind_param(stmt, index, &p)) {
+        getErrorMsg(conn, error_msg);
+        return false;
+    }
+    return true;
+}
+
+bool StreamParams::send(a_sqlany_stmt* stmt, a_sqlany_connection* conn, std::string& error_msg) {
+    std::string chunk;
+    for (Entry& entry : streams) {
+        bool text = false;
+        bool first_text = false;
+        bool done = false;
+        bool sent = false;
+        while (entry.stream->next(chunk, text, done, error_msg)) {
+            if (!sent) {
+                // The first chunk decides whether the value is bound as text
+                // (converted to the database charset) or as bytes.
+                if (!bindStream(stmt, conn, entry.index, text ? A_STRING : A_BINARY, error_msg)) {
+                    break;
+                }
+                first_text = text;
+            } else if (text != first_text) {
+                error_msg = "A stream parameter must not mix strings and Buffers.";
+                break;
+            }
+            if (!api.sqlany_send_param_data(stmt, entry.index, &chunk[0], chunk.size())) {
+                getErrorMsg(conn, error_msg);
+                break;
+            }
+            sent = true;
+        }
+        if (!done) {
+            // Discard what was sent so that a prepared statement can run again.
+#if _SACAPI_VERSION+0 >= SQLANY_API_VERSION_5
+            if (sent && apiVersion >= SQLANY_API_VERSION_5 && api.sqlany_reset_param_data != NULL) {
+                api.sqlany_reset_param_data(stmt, entry.index);
+            }
+#endif
+            return false;
+        }
+        if (!sent) {
+            // An empty source is an empty value, not NULL.
+            char empty = '\0';
+            if (!bindStream(stmt, conn, entry.index, A_BINARY, error_msg)) {
+                return false;
+            }
+            if (!api.sqlany_send_param_data(stmt, entry.index, &empty, 0)) {
+                getErrorMsg(conn, error_msg);
+                return false;
+            }
+        }
+    }
+    return true;
+}
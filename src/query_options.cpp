@@ -0,0 +1,126 @@
+#include "h/query_options.h"
+#include <cmath>
+
+bool parseQueryOptions(const Napi::Value& value, QueryOptions& options, std::string& error_msg) {
+    Napi::Object obj = value.As<Napi::Object>();
+    Napi::Value row_mode = obj.Get("rowMode");
+    if (!row_mode.IsUndefined()) {
+        std::string mode = row_mode.IsString() ? row_mode.As<Napi::String>().Utf8Value() : "";
+        if (mode == "object") { options.row_mode = RowMode::Object; }
+        else if (mode == "array") { options.row_mode = RowMode::Array; }
+        else if (mode == "columnar") { options.row_mode = RowMode::Columnar; }
+        else {
+            error_msg = "Invalid rowMode: expecting 'object', 'array' or 'columnar'.";
+            return false;
+        }
+    }
+    Napi::Value cursor = obj.Get("cursor");
+    if (!cursor.IsUndefined()) {
+        options.cursor = cursor.ToBoolean().Value();
+    }
+    Napi::Value fetch_size = obj.Get("fetchSize");
+    if (!fetch_size.IsUndefined()) {
+        double rows = fetch_size.IsNumber() ? fetch_size.As<Napi::Number>().DoubleValue() : 0;
+        if (!(rows >= 1 && rows <= 4294967295.0) || std::floor(rows) != rows) {
+            error_msg = "Invalid fetchSize: expecting an integer number of rows from 1 to 4294967295.";
+            return false;
+        }
+        options.fetch_size = (uint32_t)rows;
+    }
+    Napi::Value max_rows = obj.Get("maxRows");
+    if (!max_rows.IsUndefined()) {
+        // Uint32Value() would wrap -1 to 4294967295 and 2^32 to 0.
+        double rows = max_rows.IsNumber() ? max_rows.As<Napi::Number>().DoubleValue() : -1;
+        if (!(rows >= 0 && rows <= 9007199254740991.0) || std::floor(rows) != rows) {
+            error_msg = "Invalid maxRows: expecting a non-negative safe integer number of rows.";
+            return false;
+        }
+        options.max_rows = (uint64_t)rows;
+    }
+    Napi::Value lobs = obj.Get("lobs");
+    if (!lobs.IsUndefined()) {
+        std::string mode = lobs.IsString() ? lobs.As<Napi::String>().Utf8Value() : "";
+        if (mode == "buffer") { options.stream_lobs = false; }
+        else if (mode == "stream") { options.stream_lobs = true; }
+        else {
+            error_msg = "Invalid lobs: expecting 'buffer' or 'stream'.";
+            return false;
+        }
+    }
+    Napi::Value intern_strings = obj.Get("internStrings");
+    if (!intern_strings.IsUndefined()) {
+        options.intern_strings = intern_strings.ToBoolean().Value();
+    }
+    Napi::Value dates = obj.Get("dates");
+    if (!dates.IsUndefined()) {
+        std::string mode = dates.IsString() ? dates.As<Napi::String>().Utf8Value() : "";
+        if (mode == "string") { options.dates = DateMode::String; }
+        else if (mode == "date") { options.dates = DateMode::Date; }
+        else if (mode == "epoch") { options.dates = DateMode::Epoch; }
+        else {
+            error_msg = "Invalid dates: expecting 'string', 'date' or 'epoch'.";
+            return false;
+        }
+    }
+    Napi::Value int64 = obj.Get("int64");
+    if (!int64.IsUndefined()) {
+        std::string mode = int64.IsString() ? int64.As<Napi::String>().Utf8Value() : "";
+        if (mode == "number") { options.int64 = Int64Mode::Number; }
+        else if (mode == "bigint") { options.int64 = Int64Mode::BigInt; }
+        else if (mode == "string") { options.int64 = Int64Mode::String; }
+        else {
+            error_msg = "Invalid int64: expecting 'number', 'bigint' or 'string'.";
+            return false;
+        }
+    }
+    Napi::Value format = obj.Get("format");
+    if (!format.IsUndefined()) {
+        std::string mode = format.IsString() ? format.As<Napi::String>().Utf8Value() : "";
+        if (mode == "rows") { options.format = OutputFormat::Rows; }
+        else if (mode == "arrow") { options.format = OutputFormat::Arrow; }
+        else if (mode == "json") { options.format = OutputFormat::Json; }
+        else {
+            error_msg = "Invalid format: expecting 'rows', 'arrow' or 'json'.";
+            return false;
+        }
+    }
+    if (options.stream_lobs && (!options.cursor || options.row_mode == RowMode::Columnar ||
+                                options.format != OutputFormat::Rows)) {
+        error_msg = "lobs: 'stream' requires cursor: true and a row-based rowMode.";
+        return false;
+    }
+    return true;
+}
+
+void applyResultShape(QueryOptions& options, ResultShape shape) {
+    options.shape = shape;
+    if (shape != ResultShape::Rows) {
+        options.max_rows = 1;
+        options.cursor = false;
+        options.stream_lobs = false;
+        options.format = OutputFormat::Rows;
+    }
+}
+
+bool parseExecArgs(const Napi::CallbackInfo& info, size_t begin, size_t end, const char* method,
+                   Napi::Array& params, QueryOptions& options, std::string& error_msg) {
+    bool have_params = false;
+    bool have_options = false;
+    for (size_t i = begin; i < end; i++) {
+        Napi::Value arg = info[i];
+        if (arg.IsNull() || arg.IsUndefined()) {
+            continue;
+        }
+        if (arg.IsArray() && !have_params && !have_options) {
+            params = arg.As<Napi::Array>();
+            have_params = true;
+        } else if (arg.IsObject() && !arg.IsArray() && !have_options) {
+            if (!parseQueryOptions(arg, options, error_msg)) { return false; }
+            have_options = true;
+        } else {
+            error_msg = std::string("Parameters for ") + method + " must be an array, optionally followed by an options object.";
+            return false;
+        }
+    }
+    return true;
+}
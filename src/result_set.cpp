@@ -0,0 +1,755 @@
+#include "h/result_set.h"
+#include "h/sqlany_utils.h"
+#include "h/temporal.h"
+#include "h/arrow.h"
+#include "h/export.h"
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESULT_SET_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RESULT_SET_NEON 1
+#endif
+
+static const char* storageName(ColumnStorage storage) {
+    switch (storage) {
+        case ColumnStorage::Int32: return "int32";
+        case ColumnStorage::Uint32: return "uint32";
+        case ColumnStorage::Int64: return "int64";
+        case ColumnStorage::Uint64: return "uint64";
+        case ColumnStorage::Double: return "double";
+        case ColumnStorage::String: return "string";
+        case ColumnStorage::Binary: return "binary";
+        case ColumnStorage::Timestamp: return "timestamp";
+        case ColumnStorage::Lob: return "lob";
+        default: return "unsupported";
+    }
+}
+
+static ColumnStorage storageFor(a_sqlany_data_type type) {
+    switch (type) {
+        case A_VAL8:
+        case A_UVAL8:
+        case A_VAL16:
+        case A_UVAL16:
+        case A_VAL32: return ColumnStorage::Int32;
+        case A_UVAL32: return ColumnStorage::Uint32;
+        case A_VAL64: return ColumnStorage::Int64;
+        case A_UVAL64: return ColumnStorage::Uint64;
+        case A_DOUBLE:
+        case A_FLOAT: return ColumnStorage::Double;
+        case A_STRING: return ColumnStorage::String;
+        case A_BINARY: return ColumnStorage::Binary;
+        default: return ColumnStorage::Unsupported;
+    }
+}
+
+// Hands a native buffer over to JavaScript as an ArrayBuffer. The vector's
+// storage is adopted without copying where the runtime allows external
+// memory; otherwise (or for empty buffers) the bytes are copied.
+template <typename T>
+static Napi::ArrayBuffer releaseToArrayBuffer(Napi::Env env, std::vector<T>& values) {
+    size_t byte_length = values.size() * sizeof(T);
+    napi_value result;
+    if (byte_length > 0) {
+        std::vector<T>* owned = new std::vector<T>(std::move(values));
+        napi_status status = napi_create_external_arraybuffer(env, owned->data(), byte_length,
+            [](napi_env, void*, void* hint) { delete static_cast<std::vector<T>*>(hint); }, owned, &result);
+        if (status == napi_ok) {
+            return Napi::ArrayBuffer(env, result);
+        }
+        values = std::move(*owned);
+        delete owned;
+    }
+    void* data;
+    napi_create_arraybuffer(env, byte_length, &data, &result);
+    if (byte_length > 0) { memcpy(data, values.data(), byte_length); }
+    std::vector<T>().swap(values);
+    return Napi::ArrayBuffer(env, result);
+}
+
+// True when no byte has the high bit set. Runs on the worker thread so that
+// the main thread can create such strings as Latin-1 and skip UTF-8 decoding.
+static bool isAscii(const char* p, size_t len) {
+    size_t i = 0;
+#if defined(RESULT_SET_SSE2)
+    for (; i + 16 <= len; i += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))) != 0) { return false; }
+    }
+#elif defined(RESULT_SET_NEON)
+    for (; i + 16 <= len; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p + i))) >= 0x80) { return false; }
+    }
+#endif
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        if (word & 0x8080808080808080ull) { return false; }
+    }
+    for (; i < len; i++) {
+        if (static_cast<unsigned char>(p[i]) & 0x80) { return false; }
+    }
+    return true;
+}
+
+template <typename T>
+static void pushFixed(std::vector<char>& fixed, T value) {
+    size_t pos = fixed.size();
+    fixed.resize(pos + sizeof(T));
+    memcpy(fixed.data() + pos, &value, sizeof(T));
+}
+
+bool ResultSet::appendValue(ResultColumn& col, const a_sqlany_data_value& val, size_t row) {
+    if ((row & 7) == 0) { col.null_bits.push_back(0); }
+    bool is_null = *val.is_null != 0;
+    if (is_null) { col.null_bits[row >> 3] |= (uint8_t)(1 << (row & 7)); }
+
+    switch (col.storage) {
+        case ColumnStorage::Int32: {
+            int32_t v = 0;
+            if (!is_null) {
+                switch (val.type) {
+                    case A_VAL8: v = *(signed char*)val.buffer; break;
+                    case A_UVAL8: v = *(unsigned char*)val.buffer; break;
+                    case A_VAL16: v = *(short*)val.buffer; break;
+                    case A_UVAL16: v = *(unsigned short*)val.buffer; break;
+                    default: v = *(int*)val.buffer; break;
+                }
+            }
+            pushFixed(col.fixed, v);
+            break;
+        }
+        case ColumnStorage::Uint32:
+            pushFixed(col.fixed, is_null ? 0u : *(unsigned int*)val.buffer);
+            break;
+        case ColumnStorage::Int64:
+            pushFixed(col.fixed, is_null ? 0ll : *(long long*)val.buffer);
+            break;
+        case ColumnStorage::Uint64:
+        case ColumnStorage::Lob:
+            pushFixed(col.fixed, is_null ? 0ull : *(unsigned long long*)val.buffer);
+            break;
+        case ColumnStorage::Double: {
+            double v = 0;
+            if (!is_null) { v = val.type == A_DOUBLE ? *(double*)val.buffer : *(float*)val.buffer; }
+            pushFixed(col.fixed, v);
+            break;
+        }
+        case ColumnStorage::String:
+        case ColumnStorage::Binary:
+            if (col.storage == ColumnStorage::String && (row & 7) == 0) { col.ascii_bits.push_back(0); }
+            if (!is_null) {
+                size_t len = *val.length;
+                if (col.data.size() + len > std::numeric_limits<uint32_t>::max()) { return false; }
+                if (col.storage == ColumnStorage::String && isAscii(val.buffer, len)) {
+                    col.ascii_bits[row >> 3] |= (uint8_t)(1 << (row & 7));
+                }
+                col.data.insert(col.data.end(), val.buffer, val.buffer + len);
+            }
+            col.offsets.push_back((uint32_t)col.data.size());
+            break;
+        case ColumnStorage::Timestamp: {
+            if (format == OutputFormat::Arrow) {
+                // Arrow takes the wall-clock value as written, to the microsecond.
+                int64_t micros = ARROW_INVALID_TIMESTAMP;
+                if (!is_null && !parseWallClock(val.buffer, *val.length, micros)) {
+                    micros = ARROW_INVALID_TIMESTAMP;
+                }
+                pushFixed(col.fixed, micros);
+                col.offsets.push_back((uint32_t)col.data.size());
+                break;
+            }
+            double ms = std::numeric_limits<double>::quiet_NaN();
+            if (!is_null && !parseTimestamp(val.buffer, *val.length, ms)) {
+                ms = std::numeric_limits<double>::quiet_NaN();
+                if (col.data.size() + *val.length > std::numeric_limits<uint32_t>::max()) { return false; }
+                col.data.insert(col.data.end(), val.buffer, val.buffer + *val.length);
+            }
+            pushFixed(col.fixed, ms);
+            col.offsets.push_back((uint32_t)col.data.size());
+            break;
+        }
+        case ColumnStorage::Unsupported:
+            break;
+    }
+    return true;
+}
+
+bool ResultSet::describe(a_sqlany_stmt* stmt, a_sqlany_connection* conn, std::string& error_msg, const QueryOptions& options) {
+    int num_cols = api.sqlany_num_cols(stmt);
+    if (num_cols <= 0) {
+        affected_rows = api.sqlany_affected_rows(stmt);
+        exhausted = true;
+        return true;
+    }
+    has_columns = true;
+    // Encoded output carries the string bytes themselves, so there is nothing to intern.
+    format = options.format;
+    intern_strings = options.intern_strings && format == OutputFormat::Rows;
+    int64_mode = options.int64;
+    date_mode = options.dates;
+    columns.resize(num_cols);
+    for (int i = 0; i < num_cols; i++) {
+        a_sqlany_column_info info;
+        if (!api.sqlany_get_column_info(stmt, i, &info)) {
+            getErrorMsg(conn, error_msg);
+            return false;
+        }
+        ResultColumn& col = columns[i];
+        col.name = info.name;
+        col.type = info.type;
+        col.native_type = info.native_type;
+        col.max_size = info.max_size;
+        col.nullable = info.nullable != 0;
+        col.storage = storageFor(info.type);
+        if (options.stream_lobs && (info.native_type == DT_LONGBINARY || info.native_type == DT_LONGVARCHAR ||
+                            info.native_type == DT_LONGNVARCHAR)) {
+            col.storage = ColumnStorage::Lob;
+            has_lobs = true;
+        }
+        // Arrow output always types DATE / TIMESTAMP columns.
+        if ((options.dates != DateMode::String || format == OutputFormat::Arrow) && info.type == A_STRING &&
+            (info.native_type == DT_DATE || info.native_type == DT_TIMESTAMP)) {
+            col.storage = ColumnStorage::Timestamp;
+        }
+        col.offsets.push_back(0);
+    }
+    return true;
+}
+
+// Bytes bound per row for a column in a wide fetch, or 0 if the column cannot
+// be bound. Strings reserve room for multi-byte characters and a terminator.
+static size_t boundWidth(const ResultColumn& col) {
+    switch (col.type) {
+        case A_VAL8:
+        case A_UVAL8: return 1;
+        case A_VAL16:
+        case A_UVAL16: return 2;
+        case A_VAL32:
+        case A_UVAL32:
+        case A_FLOAT: return 4;
+        case A_VAL64:
+        case A_UVAL64:
+        case A_DOUBLE: return 8;
+        case A_STRING: return col.max_size > 0 ? col.max_size * 4 + 1 : 0;
+        case A_BINARY: return col.max_size;
+        default: return 0;
+    }
+}
+
+// Wide fetches are capped so that the bound arrays of one rowset stay small;
+// columns wider than WIDE_MAX_CELL (long types report no usable max_size)
+// are fetched one row at a time instead.
+static const size_t WIDE_MAX_ROWS = 1024;
+static const size_t WIDE_MAX_CELL = 8192;
+static const size_t WIDE_BUFFER_BUDGET = 1024 * 1024;
+
+size_t ResultSet::wideRowsetRows() const {
+    if (apiVersion < SQLANY_API_VERSION_4 || api.sqlany_set_rowset_size == NULL ||
+        api.sqlany_bind_column == NULL || api.sqlany_clear_column_bindings == NULL ||
+        api.sqlany_fetched_rows == NULL || api.sqlany_set_rowset_pos == NULL) {
+        return 0;
+    }
+    size_t row_bytes = 0;
+    for (const ResultColumn& col : columns) {
+        size_t width = boundWidth(col);
+        if (width == 0 || width > WIDE_MAX_CELL) {
+            return 0;
+        }
+        row_bytes += width + sizeof(size_t) + sizeof(sacapi_bool);
+    }
+    return std::min(WIDE_MAX_ROWS, WIDE_BUFFER_BUDGET / row_bytes);
+}
+
+bool ResultSet::fetchRowsWide(a_sqlany_stmt* stmt, a_sqlany_connection* conn, size_t max_rows,
+                              size_t rowset_rows, std::string& error_msg) {
+    struct BoundColumn {
+        size_t width;
+        std::vector<char> buffer;
+        std::vector<size_t> lengths;
+        std::vector<sacapi_bool> nulls;
+    };
+    size_t num_cols = columns.size();
+    rowset_rows = std::min(rowset_rows, max_rows);
+    std::vector<BoundColumn> bound(num_cols);
+    bool ok = true;
+    if (api.sqlany_set_column_bind_type != NULL) {
+        api.sqlany_set_column_bind_type(stmt, 0);
+    }
+    for (size_t i = 0; i < num_cols && ok; i++) {
+        BoundColumn& b = bound[i];
+        b.width = boundWidth(columns[i]);
+        b.buffer.resize(b.width * rowset_rows);
+        b.lengths.resize(rowset_rows);
+        b.nulls.resize(rowset_rows);
+        a_sqlany_data_value value = {};
+        value.buffer = b.buffer.data();
+        value.buffer_size = b.width;
+        value.length = b.lengths.data();
+        value.type = columns[i].type;
+        value.is_null = b.nulls.data();
+        ok = api.sqlany_bind_column(stmt, (sacapi_u32)i, &value) != 0;
+    }
+
+    size_t fetched = 0;
+    while (ok && fetched < max_rows) {
+        size_t want = std::min(rowset_rows, max_rows - fetched);
+        if (!api.sqlany_set_rowset_size(stmt, (sacapi_u32)want)) {
+            ok = false;
+            break;
+        }
+        if (!api.sqlany_fetch_next(stmt)) {
+            exhausted = true;
+            break;
+        }
+        sacapi_i32 got = api.sqlany_fetched_rows(stmt);
+        if (got < 0) {
+            ok = false;
+            break;
+        }
+        for (size_t r = 0; r < (size_t)got && ok; r++) {
+            for (size_t i = 0; i < num_cols; i++) {
+                BoundColumn& b = bound[i];
+                a_sqlany_data_value val = {};
+                val.buffer = b.buffer.data() + r * b.width;
+                val.buffer_size = b.width;
+                val.length = &b.lengths[r];
+                val.type = columns[i].type;
+                val.is_null = &b.nulls[r];
+                // A value that did not fit its bound slot is read again in
+                // full; only possible when max_size underestimates the data.
+                bool truncated = !b.nulls[r] && (columns[i].storage == ColumnStorage::String
+                    ? b.lengths[r] >= b.width : b.lengths[r] > b.width);
+                if (truncated && (!api.sqlany_set_rowset_pos(stmt, (sacapi_u32)r) ||
+                                  !api.sqlany_get_column(stmt, (sacapi_u32)i, &val))) {
+                    ok = false;
+                    break;
+                }
+                if (!appendValue(columns[i], val, row_count)) {
+                    error_msg = "Result set is too large to be fetched in one call.";
+                    ok = false;
+                    break;
+                }
+            }
+            if (ok) {
+                row_count++;
+            }
+        }
+        fetched += (size_t)got;
+    }
+
+    char buffer[SACAPI_ERROR_SIZE];
+    if (ok && exhausted && api.sqlany_error(conn, buffer, sizeof(buffer)) < 0) {
+        ok = false;
+    }
+    if (!ok && error_msg.empty()) {
+        getErrorMsg(conn, error_msg);
+    }
+
+    // Leave the statement as a plain cursor again: the bound arrays are about
+    // to be freed, and later callers fetch one row at a time.
+    api.sqlany_clear_column_bindings(stmt);
+    api.sqlany_set_rowset_size(stmt, 1);
+    return ok;
+}
+
+bool ResultSet::fetchRows(a_sqlany_stmt* stmt, a_sqlany_connection* conn, size_t max_rows, std::string& error_msg) {
+    // Fetch whole rowsets into bound column arrays when the client library
+    // supports it and every column has a bounded width; otherwise fall back
+    // to one sqlany_fetch_next per row.
+    if (has_lobs) {
+        max_rows = std::min<size_t>(max_rows, 1);
+    }
+    size_t rowset_rows = max_rows > 1 ? wideRowsetRows() : 0;
+    bool ok = rowset_rows > 1 ? fetchRowsWide(stmt, conn, max_rows, rowset_rows, error_msg)
+                              : fetchRowsSingle(stmt, conn, max_rows, error_msg);
+    if (ok && intern_strings) {
+        buildDictionaries();
+    }
+    if (ok && format != OutputFormat::Rows) {
+        ok = encode(error_msg);
+    }
+    return ok;
+}
+
+bool ResultSet::fetchRowsSingle(a_sqlany_stmt* stmt, a_sqlany_connection* conn, size_t max_rows, std::string& error_msg) {
+    size_t num_cols = columns.size();
+    size_t fetched = 0;
+    while (fetched < max_rows) {
+        if (!api.sqlany_fetch_next(stmt)) {
+            exhausted = true;
+            break;
+        }
+        for (size_t i = 0; i < num_cols; i++) {
+            a_sqlany_data_value val;
+            a_sqlany_data_info info;
+            unsigned long long lob_size = 0;
+            if (columns[i].storage == ColumnStorage::Lob) {
+                // Only the length is read here; Lob.read pulls the data later.
+                if (!api.sqlany_get_data_info(stmt, (sacapi_u32)i, &info)) {
+                    getErrorMsg(conn, error_msg);
+                    return false;
+                }
+                lob_size = info.data_size;
+                val.buffer = (char*)&lob_size;
+                val.is_null = &info.is_null;
+            } else if (!api.sqlany_get_column(stmt, (sacapi_u32)i, &val)) {
+                getErrorMsg(conn, error_msg);
+                return false;
+            }
+            if (!appendValue(columns[i], val, row_count)) {
+                error_msg = "Result set is too large to be fetched in one call.";
+                return false;
+            }
+        }
+        row_count++;
+        fetched++;
+    }
+    if (!exhausted) {
+        return true;
+    }
+
+    // sqlany_fetch_next also returns false on failure, so tell a real error
+    // apart from the end of the cursor (code 100) or a warning.
+    char buffer[SACAPI_ERROR_SIZE];
+    if (api.sqlany_error(conn, buffer, sizeof(buffer)) < 0) {
+        getErrorMsg(conn, error_msg);
+        return false;
+    }
+    return true;
+}
+
+// Maps every distinct value of each string column to a code, so that toJS
+// creates one JavaScript string per distinct value instead of one per row.
+void ResultSet::buildDictionaries() {
+    for (ResultColumn& col : columns) {
+        if (col.storage != ColumnStorage::String) {
+            continue;
+        }
+        std::unordered_map<std::string_view, uint32_t> codes;
+        col.dict_codes.assign(row_count, 0);
+        col.dict_rows.clear();
+        for (size_t r = 0; r < row_count; r++) {
+            if (col.isNull(r)) {
+                continue;
+            }
+            std::string_view value(col.data.data() + col.offsets[r], col.offsets[r + 1] - col.offsets[r]);
+            auto inserted = codes.emplace(value, (uint32_t)col.dict_rows.size());
+            if (inserted.second) {
+                col.dict_rows.push_back((uint32_t)r);
+            }
+            col.dict_codes[r] = inserted.first->second;
+        }
+    }
+}
+
+// Creates the JavaScript string of every dictionary entry up front; each
+// entry is used by at least one row.
+void ResultSet::dictionariesToJS(Napi::Env env) {
+    dict_values.assign(columns.size(), std::vector<napi_value>());
+    for (size_t c = 0; c < columns.size(); c++) {
+        const ResultColumn& col = columns[c];
+        if (col.storage != ColumnStorage::String || col.dict_codes.empty()) {
+            continue;
+        }
+        dict_values[c].reserve(col.dict_rows.size());
+        for (uint32_t row : col.dict_rows) {
+            dict_values[c].push_back(stringToJS(env, col, row));
+        }
+    }
+}
+
+bool ResultSet::fetch(a_sqlany_stmt* stmt, a_sqlany_connection* conn, std::string& error_msg, const QueryOptions& options) {
+    if (!describe(stmt, conn, error_msg, options)) {
+        return false;
+    }
+    return !has_columns || fetchRows(stmt, conn, options.max_rows ? (size_t)std::min<uint64_t>(options.max_rows, SIZE_MAX) : SIZE_MAX, error_msg);
+}
+
+Napi::Value ResultSet::stringToJS(Napi::Env env, const ResultColumn& col, size_t r) const {
+    const char* str = col.data.data() + col.offsets[r];
+    size_t len = col.offsets[r + 1] - col.offsets[r];
+    napi_value value;
+    if (((col.ascii_bits[r >> 3] >> (r & 7)) & 1) &&
+        napi_create_string_latin1(env, str, len, &value) == napi_ok) {
+        return Napi::Value(env, value);
+    }
+    return Napi::String::New(env, str, len);
+}
+
+Napi::Value ResultSet::cellToJS(Napi::Env env, const ResultColumn& col, size_t r) const {
+    if (col.isNull(r)) {
+        return env.Null();
+    }
+    switch (col.storage) {
+        case ColumnStorage::Int32:
+            return Napi::Number::New(env, col.fixedAt<int32_t>(r));
+        case ColumnStorage::Uint32:
+            return Napi::Number::New(env, col.fixedAt<uint32_t>(r));
+        case ColumnStorage::Int64: {
+            int64_t v = col.fixedAt<int64_t>(r);
+            if (int64_mode == Int64Mode::BigInt) { return Napi::BigInt::New(env, v); }
+            if (int64_mode == Int64Mode::String) { return Napi::String::New(env, std::to_string(v)); }
+            return Napi::Number::New(env, (double)v);
+        }
+        case ColumnStorage::Uint64: {
+            uint64_t v = col.fixedAt<uint64_t>(r);
+            if (int64_mode == Int64Mode::BigInt) { return Napi::BigInt::New(env, v); }
+            if (int64_mode == Int64Mode::String) { return Napi::String::New(env, std::to_string(v)); }
+            return Napi::Number::New(env, (double)v);
+        }
+        case ColumnStorage::Double:
+            return Napi::Number::New(env, col.fixedAt<double>(r));
+        case ColumnStorage::String: {
+            size_t c = &col - columns.data();
+            if (c < dict_values.size() && !dict_values[c].empty()) {
+                return Napi::Value(env, dict_values[c][col.dict_codes[r]]);
+            }
+            return stringToJS(env, col, r);
+        }
+        case ColumnStorage::Binary: {
+            size_t c = &col - columns.data();
+            if (buffer_from && binary_slabs[c]) {
+                napi_value args[3] = {
+                    binary_slabs[c],
+                    Napi::Number::New(env, col.offsets[r]),
+                    Napi::Number::New(env, col.offsets[r + 1] - col.offsets[r]),
+                };
+                napi_value view;
+                if (napi_call_function(env, env.Undefined(), buffer_from, 3, args, &view) == napi_ok) {
+                    return Napi::Value(env, view);
+                }
+            }
+            return Napi::Buffer<char>::Copy(env, col.data.data() + col.offsets[r], col.offsets[r + 1] - col.offsets[r]);
+        }
+        case ColumnStorage::Timestamp: {
+            double ms = col.fixedAt<double>(r);
+            if (std::isnan(ms)) {
+                return Napi::String::New(env, col.data.data() + col.offsets[r], col.offsets[r + 1] - col.offsets[r]);
+            }
+            if (date_mode == DateMode::Date) { return Napi::Date::New(env, ms); }
+            return Napi::Number::New(env, ms);
+        }
+        case ColumnStorage::Lob:
+            if (lob_value) {
+                return lob_value(env, (sacapi_u32)(&col - columns.data()), col.fixedAt<uint64_t>(r), first_position + r);
+            }
+            return env.Null();
+        default:
+            return Napi::String::New(env, "Unsupported Type");
+    }
+}
+
+Napi::Array ResultSet::columnsToJS(Napi::Env env) const {
+    Napi::Array list = Napi::Array::New(env);
+    for (size_t c = 0; c < columns.size(); c++) {
+        const ResultColumn& col = columns[c];
+        Napi::Object desc = Napi::Object::New(env);
+        desc.Set("name", Napi::String::New(env, col.name));
+        desc.Set("type", Napi::String::New(env, storageName(col.storage)));
+        desc.Set("nativeType", Napi::Number::New(env, col.native_type));
+        desc.Set("nullable", Napi::Boolean::New(env, col.nullable));
+        list.Set((uint32_t)c, desc);
+    }
+    return list;
+}
+
+Napi::Value ResultSet::rowsToObjects(Napi::Env env) const {
+    // Property keys are created once per result set and shared by every row,
+    // rather than building a new string from the column name for each cell.
+    std::vector<napi_value> keys;
+    keys.reserve(columns.size());
+    for (const ResultColumn& col : columns) {
+        keys.push_back(Napi::String::New(env, col.name));
+    }
+    Napi::Array results = Napi::Array::New(env);
+    for (size_t r = 0; r < row_count; r++) {
+        Napi::Object row = Napi::Object::New(env);
+        for (size_t c = 0; c < columns.size(); c++) {
+            row.Set(keys[c], cellToJS(env, columns[c], r));
+        }
+        results.Set((uint32_t)r, row);
+    }
+    return results;
+}
+
+Napi::Value ResultSet::firstRowToJS(Napi::Env env, bool as_array) const {
+    if (as_array) {
+        Napi::Array row = Napi::Array::New(env, columns.size());
+        for (size_t c = 0; c < columns.size(); c++) {
+            row.Set((uint32_t)c, cellToJS(env, columns[c], 0));
+        }
+        return row;
+    }
+    Napi::Object row = Napi::Object::New(env);
+    for (const ResultColumn& col : columns) {
+        row.Set(col.name, cellToJS(env, col, 0));
+    }
+    return row;
+}
+
+Napi::Value ResultSet::rowsToArrays(Napi::Env env) const {
+    // Rows are filled front to back so V8 keeps them as packed element arrays.
+    Napi::Array rows = Napi::Array::New(env);
+    for (size_t r = 0; r < row_count; r++) {
+        Napi::Array row = Napi::Array::New(env);
+        for (size_t c = 0; c < columns.size(); c++) {
+            row.Set((uint32_t)c, cellToJS(env, columns[c], r));
+        }
+        rows.Set((uint32_t)r, row);
+    }
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("columns", columnsToJS(env));
+    result.Set("rows", rows);
+    return result;
+}
+
+Napi::Value ResultSet::columnsToTypedArrays(Napi::Env env) {
+    Napi::Array list = columnsToJS(env);
+    size_t bitmap_bytes = (row_count + 7) / 8;
+    for (size_t c = 0; c < columns.size(); c++) {
+        ResultColumn& col = columns[c];
+        Napi::Object desc = list.Get((uint32_t)c).As<Napi::Object>();
+        col.null_bits.resize(bitmap_bytes);
+        desc.Set("nulls", Napi::Uint8Array::New(env, bitmap_bytes, releaseToArrayBuffer(env, col.null_bits), 0));
+        switch (col.storage) {
+            case ColumnStorage::Int32:
+                desc.Set("values", Napi::Int32Array::New(env, row_count, releaseToArrayBuffer(env, col.fixed), 0));
+                break;
+            case ColumnStorage::Uint32:
+                desc.Set("values", Napi::Uint32Array::New(env, row_count, releaseToArrayBuffer(env, col.fixed), 0));
+                break;
+            case ColumnStorage::Int64:
+                desc.Set("values", Napi::BigInt64Array::New(env, row_count, releaseToArrayBuffer(env, col.fixed), 0));
+                break;
+            case ColumnStorage::Uint64:
+                desc.Set("values", Napi::BigUint64Array::New(env, row_count, releaseToArrayBuffer(env, col.fixed), 0));
+                break;
+            case ColumnStorage::Double:
+            case ColumnStorage::Timestamp:
+                desc.Set("values", Napi::Float64Array::New(env, row_count, releaseToArrayBuffer(env, col.fixed), 0));
+                break;
+            case ColumnStorage::String:
+            case ColumnStorage::Binary: {
+                if (c < dict_values.size() && !col.dict_codes.empty()) {
+                    Napi::Array dictionary = Napi::Array::New(env, dict_values[c].size());
+                    for (size_t k = 0; k < dict_values[c].size(); k++) {
+                        dictionary.Set((uint32_t)k, Napi::Value(env, dict_values[c][k]));
+                    }
+                    desc.Set("dictionary", dictionary);
+                    desc.Set("codes", Napi::Uint32Array::New(env, row_count, releaseToArrayBuffer(env, col.dict_codes), 0));
+                }
+                size_t data_length = col.data.size();
+                desc.Set("offsets", Napi::Uint32Array::New(env, row_count + 1, releaseToArrayBuffer(env, col.offsets), 0));
+                desc.Set("data", Napi::Uint8Array::New(env, data_length, releaseToArrayBuffer(env, col.data), 0));
+                break;
+            }
+            case ColumnStorage::Lob:
+            case ColumnStorage::Unsupported:
+                break;
+        }
+    }
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("rowCount", Napi::Number::New(env, (double)row_count));
+    result.Set("columns", list);
+    return result;
+}
+
+// Binary cells of row results are handed out as Buffer views into one
+// ArrayBuffer per column, which adopts the column's data without a copy,
+// instead of allocating and copying a Buffer per cell. The views keep the
+// whole column's data alive until the last of them is collected.
+void ResultSet::shareBinaryData(Napi::Env env) {
+    binary_slabs.assign(columns.size(), nullptr);
+    bool any = false;
+    for (const ResultColumn& col : columns) {
+        any = any || (col.storage == ColumnStorage::Binary && row_count > 0);
+    }
+    if (!any) {
+        return;
+    }
+    Napi::Value buffer = env.Global().Get("Buffer");
+    Napi::Value from = buffer.IsFunction() ? buffer.As<Napi::Object>().Get("from") : env.Undefined();
+    if (!from.IsFunction()) {
+        return;
+    }
+    buffer_from = from;
+    for (size_t c = 0; c < columns.size(); c++) {
+        if (columns[c].storage == ColumnStorage::Binary) {
+            binary_slabs[c] = releaseToArrayBuffer(env, columns[c].data);
+        }
+    }
+}
+
+// Serializes the fetched rows for format 'arrow' or 'json'. JSON follows
+// what JSON.stringify makes of object rows with the same options, except
+// that BIGINT values with int64 'bigint' are written as exact integers.
+bool ResultSet::encode(std::string& error_msg) {
+    if (format == OutputFormat::Arrow) {
+        return writeArrowStream(columns, row_count, encoded, error_msg);
+    }
+    JsonStyle style;
+    style.int64 = int64_mode;
+    style.dates = date_mode;
+    style.buffer_objects = true;
+    encoded.push_back('[');
+    appendJsonRows(encoded, columns, row_count, ',', style);
+    if (row_count > 0) { encoded.back() = ']'; }
+    else { encoded.push_back(']'); }
+    return true;
+}
+
+// Hands the encoded bytes over as a Buffer, adopting the string's storage
+// where external memory is allowed and copying it otherwise.
+Napi::Value ResultSet::encodedToJS(Napi::Env env) {
+    napi_value result;
+    if (encoded.empty()) {
+        // A cursor batch fetched after the end of the result set still
+        // encodes as an empty batch.
+        std::string error_msg;
+        encode(error_msg);
+    }
+    std::string* owned = new std::string(std::move(encoded));
+    napi_status status = napi_create_external_buffer(env, owned->size(), &(*owned)[0],
+        [](napi_env, void*, void* hint) { delete static_cast<std::string*>(hint); }, owned, &result);
+    if (status != napi_ok) {
+        napi_create_buffer_copy(env, owned->size(), owned->data(), nullptr, &result);
+        delete owned;
+    }
+    return Napi::Value(env, result);
+}
+
+Napi::Value ResultSet::toJS(Napi::Env env, const QueryOptions& options) {
+    if (!has_columns) {
+        return Napi::Number::New(env, affected_rows);
+    }
+    int64_mode = options.int64;
+    date_mode = options.dates;
+    if (options.shape != ResultShape::Rows) {
+        // queryOne / queryScalar: nothing is built beyond the one row or value.
+        if (row_count == 0) {
+            return env.Null();
+        }
+        if (options.shape == ResultShape::Scalar) {
+            return cellToJS(env, columns[0], 0);
+        }
+        return firstRowToJS(env, options.row_mode == RowMode::Array);
+    }
+    if (format != OutputFormat::Rows) {
+        return encodedToJS(env);
+    }
+    if (intern_strings) {
+        dictionariesToJS(env);
+    }
+    if (options.row_mode == RowMode::Columnar) {
+        return columnsToTypedArrays(env);
+    }
+    shareBinaryData(env);
+    return options.row_mode == RowMode::Array ? rowsToArrays(env) : rowsToObjects(env);
+}
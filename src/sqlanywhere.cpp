@@ -5,10 +5,14 @@
 #include "h/sqlany_utils.h"
 #include "h/connection.h"
 #include "h/stmt.h"
+#include "h/cursor.h"
+#include "h/lob.h"
+#include "h/param_stream.h"
 
 // Global variables
 SQLAnywhereInterface api;
 unsigned openConnections = 0;
+sacapi_u32 apiVersion = 0;
 uv_mutex_t api_mutex;
 
 // Addon entry point
@@ -20,7 +24,22 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
             .ThrowAsJavaScriptException();
         return exports;
     }
-    if (!api.sqlany_init("node-sqlanywhere", SQLANY_API_VERSION_4, NULL)) {
+    // Ask for the newest interface first; older client libraries reject it,
+    // so step down one version at a time until one of them accepts.  The
+    // features of the missing versions are then gated on apiVersion.
+    static const sacapi_u32 versions[] = {
+        SQLANY_API_VERSION_5, SQLANY_API_VERSION_4,
+        SQLANY_API_VERSION_3, SQLANY_API_VERSION_2
+    };
+    bool initialized = false;
+    for (sacapi_u32 version : versions) {
+        if (api.sqlany_init("node-sqlanywhere", version, NULL)) {
+            apiVersion = version;
+            initialized = true;
+            break;
+        }
+    }
+    if (!initialized) {
          Napi::Error::New(env, "Failed to initialize the SQL Anywhere C API.")
             .ThrowAsJavaScriptException();
         return exports;
@@ -28,6 +47,9 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
 
     Connection::Init(env, exports);
     StmtObject::Init(env, exports);
+    Cursor::Init(env, exports);
+    Lob::Init(env, exports);
+    ParamStream::Init(env, exports);
     
     // Create a top-level createConnection function for convenience
     Napi::Function conn_constructor = exports.Get("Connection").As<Napi::Function>();
@@ -8,6 +8,10 @@ Napi::Object StmtObject::Init(Napi::Env env, Napi::Object exports) {
     Napi::HandleScope scope(env);
     Napi::Function func = DefineClass(env, "Statement", {
         InstanceMethod("exec", &StmtObject::Exec),
+        InstanceMethod("queryOne", &StmtObject::QueryOne),
+        InstanceMethod("queryScalar", &StmtObject::QueryScalar),
+        InstanceMethod("execBatch", &StmtObject::ExecBatch),
+        InstanceMethod("execBatchColumns", &StmtObject::ExecBatchColumns),
         InstanceMethod("drop", &StmtObject::Drop),
         InstanceMethod("getMoreResults", &StmtObject::GetMoreResults),
     });
@@ -20,6 +24,7 @@ Napi::Object StmtObject::Init(Napi::Env env, Napi::Object exports) {
 StmtObject::StmtObject(const Napi::CallbackInfo& info) : Napi::ObjectWrap<StmtObject>(info) {
     this->sqlany_stmt = NULL;
     this->connection = NULL;
+    this->generation = 0;
 }
 
 StmtObject::~StmtObject() {
@@ -43,28 +48,81 @@ void StmtObject::setConnection(Connection *conn_obj) {
 }
 
 Napi::Value StmtObject::Exec(const Napi::CallbackInfo& info) {
+    return queueExec(info, "Statement.exec", ResultShape::Rows);
+}
+
+Napi::Value StmtObject::QueryOne(const Napi::CallbackInfo& info) {
+    return queueExec(info, "Statement.queryOne", ResultShape::FirstRow);
+}
+
+Napi::Value StmtObject::QueryScalar(const Napi::CallbackInfo& info) {
+    return queueExec(info, "Statement.queryScalar", ResultShape::Scalar);
+}
+
+Napi::Value StmtObject::queueExec(const Napi::CallbackInfo& info, const char* method, ResultShape shape) {
     Napi::Env env = info.Env();
-    int params_idx = -1;
-    int callback_idx = 0;
     if (info.Length() < 1) {
-        throwNapiError(env, "Statement.exec requires a callback function.");
+        throwNapiError(env, std::string(method) + " requires a callback function.");
         return env.Undefined();
     }
-    if (info.Length() > 1) {
-        params_idx = 0;
-        callback_idx = 1;
-    }
+    size_t callback_idx = info.Length() - 1;
     if (!info[callback_idx].IsFunction()) {
-        throwNapiError(env, "The last argument to Statement.exec must be a callback function.");
+        throwNapiError(env, std::string("The last argument to ") + method + " must be a callback function.");
         return env.Undefined();
     }
-    if (params_idx != -1 && !info[params_idx].IsArray()) {
-        throwNapiError(env, "Parameters for Statement.exec must be an array.");
+    Napi::Array params = Napi::Array::New(env);
+    QueryOptions options = this->connection ? this->connection->defaults : QueryOptions();
+    std::string error_msg;
+    if (!parseExecArgs(info, 0, callback_idx, method, params, options, error_msg)) {
+        throwNapiTypeError(env, error_msg);
         return env.Undefined();
     }
-    Napi::Array params = (params_idx != -1) ? info[params_idx].As<Napi::Array>() : Napi::Array::New(env);
+    applyResultShape(options, shape);
     Napi::Function callback = info[callback_idx].As<Napi::Function>();
-    (new ExecStmtWorker(this, callback, params))->Queue();
+    (new ExecStmtWorker(this, callback, params, options))->Queue();
+    return env.Undefined();
+}
+
+Napi::Value StmtObject::ExecBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsFunction()) {
+        throwNapiError(env, "Invalid arguments for execBatch: expecting (rows, callback).");
+        return env.Undefined();
+    }
+    if (!this->connection || !this->sqlany_stmt) {
+        throwNapiError(env, "Statement has been dropped.");
+        return env.Undefined();
+    }
+    BatchParams params;
+    std::string error_msg;
+    if (!params.fromRows(info[0].As<Napi::Array>(), error_msg)) {
+        throwNapiError(env, error_msg);
+        return env.Undefined();
+    }
+    (new ExecBatchWorker(this, info[1].As<Napi::Function>(), std::move(params)))->Queue();
+    return env.Undefined();
+}
+
+Napi::Value StmtObject::ExecBatchColumns(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    size_t callback_idx = info.Length() - 1;
+    if (info.Length() < 2 || info.Length() > 3 || !info[0].IsObject() || info[0].IsArray() ||
+        !info[callback_idx].IsFunction()) {
+        throwNapiError(env, "Invalid arguments for execBatchColumns: expecting (columns, [nulls], callback).");
+        return env.Undefined();
+    }
+    if (!this->connection || !this->sqlany_stmt) {
+        throwNapiError(env, "Statement has been dropped.");
+        return env.Undefined();
+    }
+    BatchParams params;
+    std::string error_msg;
+    Napi::Value nulls = callback_idx == 2 ? info[1] : env.Undefined();
+    if (!params.fromColumns(info[0].As<Napi::Object>(), nulls, error_msg)) {
+        throwNapiError(env, error_msg);
+        return env.Undefined();
+    }
+    (new ExecBatchWorker(this, info[callback_idx].As<Napi::Function>(), std::move(params)))->Queue();
     return env.Undefined();
 }
 
@@ -80,11 +138,17 @@ Napi::Value StmtObject::Drop(const Napi::CallbackInfo& info) {
 
 Napi::Value StmtObject::GetMoreResults(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsFunction()) {
+    if (info.Length() < 1 || !info[info.Length() - 1].IsFunction()) {
         throwNapiError(env, "getMoreResults requires a callback function.");
         return env.Undefined();
     }
-    Napi::Function callback = info[0].As<Napi::Function>();
-    (new GetMoreResultsWorker(this, callback))->Queue();
+    QueryOptions options = this->connection ? this->connection->defaults : QueryOptions();
+    std::string error_msg;
+    if (info.Length() > 1 && info[0].IsObject() && !parseQueryOptions(info[0], options, error_msg)) {
+        throwNapiTypeError(env, error_msg);
+        return env.Undefined();
+    }
+    Napi::Function callback = info[info.Length() - 1].As<Napi::Function>();
+    (new GetMoreResultsWorker(this, callback, options))->Queue();
     return env.Undefined();
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "h/stmt_params.h"
+#include "h/param_stream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// The width of a fixed-width slot, or 0 for types that are not cached.
+static size_t fixedWidth(a_sqlany_data_type type) {
+    switch (type) {
+        case A_VAL8: case A_UVAL8: return 1;
+        case A_VAL16: case A_UVAL16: return 2;
+        case A_VAL32: case A_UVAL32: return 4;
+        case A_VAL64: case A_UVAL64: case A_DOUBLE: return 8;
+#if _SACAPI_VERSION+0 >= SQLANY_API_VERSION_5
+        case A_FLOAT: return 4;
+#endif
+        default: return 0;
+    }
+}
+
+bool parseParamTypes(const Napi::Value& value, std::vector<a_sqlany_data_type>& types, std::string& error_msg) {
+    static const struct { const char* name; a_sqlany_data_type type; } names[] = {
+        {"int8", A_VAL8}, {"uint8", A_UVAL8}, {"int16", A_VAL16}, {"uint16", A_UVAL16},
+        {"int32", A_VAL32}, {"uint32", A_UVAL32}, {"int64", A_VAL64}, {"uint64", A_UVAL64},
+        {"double", A_DOUBLE}, {"string", A_STRING}, {"binary", A_BINARY},
+    };
+    if (!value.IsArray()) {
+        error_msg = "Invalid types: expecting an array of parameter type names.";
+        return false;
+    }
+    Napi::Array list = value.As<Napi::Array>();
+    types.clear();
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        std::string name = list.Get(i).IsString() ? list.Get(i).As<Napi::String>().Utf8Value() : "";
+        a_sqlany_data_type type = A_INVALID_TYPE;
+        for (const auto& entry : names) {
+            if (name == entry.name) { type = entry.type; }
+        }
+        if (name == "float") {
+            // Clients before API version 5 have no single precision type.
+            type = A_DOUBLE;
+#if _SACAPI_VERSION+0 >= SQLANY_API_VERSION_5
+            if (apiVersion >= SQLANY_API_VERSION_5) { type = A_FLOAT; }
+#endif
+        }
+        if (type == A_INVALID_TYPE) {
+            error_msg = "Invalid types: unknown parameter type at index " + std::to_string(i) + ".";
+            return false;
+        }
+        types.push_back(type);
+    }
+    return true;
+}
+
+bool StmtParams::describe(a_sqlany_stmt* stmt, const std::vector<a_sqlany_data_type>& hints, std::string& error_msg) {
+    sacapi_i32 count = api.sqlany_num_params(stmt);
+    if (!hints.empty()) {
+        if (count >= 0 && (size_t)count != hints.size()) {
+            error_msg = "types lists " + std::to_string(hints.size()) + " parameters, but the statement has " +
+                        std::to_string(count) + ".";
+            return false;
+        }
+        std::vector<Slot> hinted_slots(hints.size());
+        for (size_t i = 0; i < hints.size(); i++) {
+            hinted_slots[i].type = hints[i];
+            hinted_slots[i].width = fixedWidth(hints[i]);
+        }
+        slots.swap(hinted_slots);
+        described = true;
+        hinted = true;
+        return true;
+    }
+    if (count < 0) {
+        return true;
+    }
+    std::vector<Slot> described_slots((size_t)count);
+    for (sacapi_i32 i = 0; i < count; i++) {
+        a_sqlany_bind_param info;
+        memset(&info, 0, sizeof(info));
+        if (!api.sqlany_describe_bind_param(stmt, (sacapi_u32)i, &info)) {
+            return true;
+        }
+        // Output parameters keep the generic path, as do types without a
+        // direct conversion from JavaScript values.
+        Slot& slot = described_slots[i];
+        if (info.direction == DD_INPUT && (info.value.type == A_STRING || fixedWidth(info.value.type) > 0)) {
+            slot.type = info.value.type;
+            slot.width = fixedWidth(info.value.type);
+        }
+    }
+    slots.swap(described_slots);
+    described = true;
+    return true;
+}
+
+// Writes `num` into `out` as `type` when it converts exactly.
+static bool fromNumber(double num, a_sqlany_data_type type, char* out) {
+    if (type == A_DOUBLE) {
+        memcpy(out, &num, sizeof(num));
+        return true;
+    }
+#if _SACAPI_VERSION+0 >= SQLANY_API_VERSION_5
+    if (type == A_FLOAT) {
+        float f = (float)num;
+        if ((double)f != num && !std::isnan(num)) { return false; }
+        memcpy(out, &f, sizeof(f));
+        return true;
+    }
+#endif
+    if (std::floor(num) != num || num > 9007199254740991.0 || num < -9007199254740991.0) {
+        return false;
+    }
+    switch (type) {
+        case A_VAL8: if (num < -128 || num > 127) { return false; } { int8_t v = (int8_t)num; memcpy(out, &v, 1); } return true;
+        case A_UVAL8: if (num < 0 || num > 255) { return false; } { uint8_t v = (uint8_t)num; memcpy(out, &v, 1); } return true;
+        case A_VAL16: if (num < -32768 || num > 32767) { return false; } { int16_t v = (int16_t)num; memcpy(out, &v, 2); } return true;
+        case A_UVAL16: if (num < 0 || num > 65535) { return false; } { uint16_t v = (uint16_t)num; memcpy(out, &v, 2); } return true;
+        case A_VAL32: if (num < -2147483648.0 || num > 2147483647.0) { return false; } { int32_t v = (int32_t)num; memcpy(out, &v, 4); } return true;
+        case A_UVAL32: if (num < 0 || num > 4294967295.0) { return false; } { uint32_t v = (uint32_t)num; memcpy(out, &v, 4); } return true;
+        case A_VAL64: { int64_t v = (int64_t)num; memcpy(out, &v, 8); } return true;
+        case A_UVAL64: if (num < 0) { return false; } { uint64_t v = (uint64_t)num; memcpy(out, &v, 8); } return true;
+        default: return false;
+    }
+}
+
+// BigInts only fill 64-bit integer slots, where they are exact.
+static bool fromBigInt(const Napi::BigInt& big, a_sqlany_data_type type, char* out) {
+    bool lossless = false;
+    if (type == A_VAL64) {
+        int64_t v = big.Int64Value(&lossless);
+        memcpy(out, &v, sizeof(v));
+    } else if (type == A_UVAL64) {
+        uint64_t v = big.Uint64Value(&lossless);
+        memcpy(out, &v, sizeof(v));
+    }
+    return lossless;
+}
+
+// Writes a number into a hinted slot. Integer slots take only integers in
+// the slot type's range (and, for 64-bit slots, the safe integer range), so a
+// value is never wrapped or truncated; floating point slots round as usual.
+static bool castNumber(double num, a_sqlany_data_type type, char* out) {
+#if _SACAPI_VERSION+0 >= SQLANY_API_VERSION_5
+    if (type == A_FLOAT) {
+        float v = (float)num;
+        memcpy(out, &v, sizeof(v));
+        return true;
+    }
+#endif
+    return fromNumber(num, type, out);
+}
+
+// The name of an integer slot type, for range errors.
+static const char* integerTypeName(a_sqlany_data_type type) {
+    switch (type) {
+        case A_VAL8: return "int8";
+        case A_UVAL8: return "uint8";
+        case A_VAL16: return "int16";
+        case A_UVAL16: return "uint16";
+        case A_VAL32: return "int32";
+        case A_UVAL32: return "uint32";
+        case A_VAL64: return "int64";
+        default: return "uint64";
+    }
+}
+
+// A value for a hinted slot. Only the JavaScript kind the type needs is
+// accepted; numbers and BigInts are written as they are for strings.
+static bool stageHinted(const Napi::Value& val, a_sqlany_data_type type, uint32_t index,
+                        ExecuteData& param_data, StagedParam& param, std::string& error_msg) {
+    const char* expected = nullptr;
+    if (type == A_STRING) {
+        if (val.IsString() || val.IsNumber() || val.IsBigInt()) {
+            Napi::String str = val.IsString() ? val.As<Napi::String>() : val.ToString();
+            napi_get_value_string_utf8(str.Env(), str, nullptr, 0, &param.length);
+            char* bytes = static_cast<char*>(param_data.allocate(param.length + 1, 1));
+            napi_get_value_string_utf8(str.Env(), str, bytes, param.length + 1, &param.length);
+            param.bytes = bytes;
+            return true;
+        }
+        expected = "a string";
+    } else if (type == A_BINARY) {
+        if (val.IsTypedArray()) {
+            Napi::TypedArray array = val.As<Napi::TypedArray>();
+            param_data.pin(array);
+            param.bytes = static_cast<const char*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+            param.length = array.ByteLength();
+            return true;
+        }
+        expected = "a Buffer";
+    } else if (val.IsNumber()) {
+        if (castNumber(val.As<Napi::Number>().DoubleValue(), type, param.fixed)) {
+            return true;
+        }
+    } else if (val.IsBigInt() && (type == A_VAL64 || type == A_UVAL64)) {
+        if (fromBigInt(val.As<Napi::BigInt>(), type, param.fixed)) {
+            return true;
+        }
+    } else {
+        expected = type == A_VAL64 || type == A_UVAL64 ? "a number or BigInt" : "a number";
+    }
+    if (expected == nullptr) {
+        error_msg = "Parameter " + std::to_string(index) + " must be an integer in the range of " +
+                    integerTypeName(type) + " or null.";
+        return false;
+    }
+    error_msg = "Parameter " + std::to_string(index) + " must be " + expected + " or null.";
+    return false;
+}
+
+bool StmtParams::stage(const Napi::Array& values, ExecuteData& param_data, std::vector<StagedParam>& staged,
+                       std::string& error_msg) const {
+    if (values.Length() != slots.size()) {
+        error_msg = "The statement takes " + std::to_string(slots.size()) + " parameters, but " +
+                    std::to_string(values.Length()) + " were given.";
+        return false;
+    }
+    staged.resize(slots.size());
+    for (uint32_t i = 0; i < slots.size(); i++) {
+        const Slot& slot = slots[i];
+        StagedParam& param = staged[i];
+        Napi::Value val = values.Get(i);
+        bool fits = false;
+        if (slot.type == A_INVALID_TYPE || ParamStream::IsSource(val)) {
+            fits = false;
+        } else if (val.IsNull() || val.IsUndefined()) {
+            param.is_null = true;
+            fits = true;
+        } else if (hinted) {
+            if (!stageHinted(val, slot.type, i, param_data, param, error_msg)) {
+                return false;
+            }
+            fits = true;
+        } else if (slot.type == A_STRING) {
+            if (val.IsString()) {
+                napi_get_value_string_utf8(val.Env(), val, nullptr, 0, &param.length);
+                char* bytes = static_cast<char*>(param_data.allocate(param.length + 1, 1));
+                napi_get_value_string_utf8(val.Env(), val, bytes, param.length + 1, &param.length);
+                param.bytes = bytes;
+                fits = true;
+            }
+        } else if (val.IsNumber()) {
+            fits = fromNumber(val.As<Napi::Number>().DoubleValue(), slot.type, param.fixed);
+        } else if (val.IsBigInt()) {
+            fits = fromBigInt(val.As<Napi::BigInt>(), slot.type, param.fixed);
+        }
+        if (!fits) {
+            param.generic = true;
+            memset(&param.bind, 0, sizeof(param.bind));
+            param.bind.direction = DD_INPUT;
+            bindParamValue(val, i, param.bind, param_data);
+        }
+    }
+    return true;
+}
+
+// Binds a slot's length and null indicator with `buffer` as its value.
+bool StmtParams::bindSlot(a_sqlany_stmt* stmt, sacapi_u32 index, Slot& slot, char* buffer, size_t size) {
+    a_sqlany_bind_param p;
+    memset(&p, 0, sizeof(p));
+    p.direction = DD_INPUT;
+    p.value.type = slot.type;
+    p.value.buffer = buffer;
+    p.value.buffer_size = size;
+    p.value.length = &slot.length;
+    p.value.is_null = &slot.is_null;
+    return api.sqlany_bind_param(stmt, index, &p) != 0;
+}
+
+bool StmtParams::apply(a_sqlany_stmt* stmt, const std::vector<StagedParam>& staged) {
+    for (size_t i = 0; i < slots.size(); i++) {
+        Slot& slot = slots[i];
+        const StagedParam& param = staged[i];
+        if (param.generic) {
+            slot.bound = false;
+            if (!api.sqlany_bind_param(stmt, (sacapi_u32)i, const_cast<a_sqlany_bind_param*>(&param.bind))) {
+                return false;
+            }
+            continue;
+        }
+        slot.is_null = param.is_null ? 1 : 0;
+        if (slot.type == A_STRING || slot.type == A_BINARY) {
+            // Strings and Buffers are bound where stage() left them, in the
+            // request's arena or in the Buffer it pins, instead of being
+            // copied again; as that moves with every execution, the
+            // parameter binds every time.
+            bool empty = param.is_null || param.bytes == nullptr;
+            size_t size = empty ? 0 : param.length + (slot.type == A_STRING ? 1 : 0);
+            slot.length = param.is_null ? 0 : param.length;
+            if (!bindSlot(stmt, (sacapi_u32)i, slot, empty ? slot.fixed : const_cast<char*>(param.bytes), size)) {
+                return false;
+            }
+            slot.bound = false;
+            continue;
+        }
+        if (!param.is_null) {
+            memcpy(slot.fixed, param.fixed, slot.width);
+            slot.length = slot.width;
+        }
+        if (slot.bound) {
+            continue;
+        }
+        if (!bindSlot(stmt, (sacapi_u32)i, slot, slot.fixed, slot.width)) {
+            return false;
+        }
+        slot.bound = true;
+    }
+    return true;
+}
+
+void StmtParams::invalidate() {
+    for (Slot& slot : slots) {
+        slot.bound = false;
+    }
+}
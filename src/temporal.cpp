@@ -0,0 +1,190 @@
+#include "h/temporal.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+// Reads exactly `count` decimal digits.
+static bool readDigits(const char*& p, const char* end, int count, int& value) {
+    if (end - p < count) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < count; i++, p++) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        value = value * 10 + (*p - '0');
+    }
+    return true;
+}
+
+static bool readChar(const char*& p, const char* end, char c) {
+    if (p < end && *p == c) {
+        p++;
+        return true;
+    }
+    return false;
+}
+
+static bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar.
+static long long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yoe = year - era * 400;
+    long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Inverse of daysFromCivil.
+static void civilFromDays(long long days, int& year, int& month, int& day) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long doe = days - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    year = (int)(yoe + era * 400 + (month <= 2));
+}
+
+// Seconds since the epoch of a wall-clock time in the host's time zone, the
+// way Date reads an ISO date-time that has no offset.
+static bool localSeconds(int year, int month, int day, int hour, int minute, int second, long long& seconds) {
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    local.tm_year = year - 1900;
+    local.tm_mon = month - 1;
+    local.tm_mday = day;
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    local.tm_sec = second;
+    local.tm_isdst = -1;
+    time_t result = mktime(&local);
+    if (result == (time_t)-1 && (local.tm_year != 69 || local.tm_mon != 11 || local.tm_mday != 31)) {
+        return false;
+    }
+    seconds = (long long)result;
+    return true;
+}
+
+// The fields of a value in the server's default ISO layout.
+struct TimestampFields {
+    int year, month, day;
+    int hour = 0, minute = 0, second = 0;
+    // Up to microseconds; further digits are dropped.
+    int micros = 0;
+    bool has_time = false;
+    bool has_offset = false;
+    int offset_minutes = 0;
+};
+
+static bool parseFields(const char* text, size_t length, TimestampFields& f) {
+    static const int days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const char* p = text;
+    const char* end = text + length;
+    while (end > p && end[-1] == ' ') {
+        end--;
+    }
+
+    if (!readDigits(p, end, 4, f.year) || !readChar(p, end, '-') || !readDigits(p, end, 2, f.month) ||
+        !readChar(p, end, '-') || !readDigits(p, end, 2, f.day)) {
+        return false;
+    }
+    if (f.month < 1 || f.month > 12 || f.day < 1 ||
+        f.day > days_in_month[f.month - 1] + (f.month == 2 && isLeapYear(f.year))) {
+        return false;
+    }
+
+    if (readChar(p, end, ' ') || readChar(p, end, 'T')) {
+        f.has_time = true;
+        if (!readDigits(p, end, 2, f.hour) || !readChar(p, end, ':') || !readDigits(p, end, 2, f.minute)) {
+            return false;
+        }
+        if (readChar(p, end, ':')) {
+            if (!readDigits(p, end, 2, f.second)) {
+                return false;
+            }
+            if (readChar(p, end, '.')) {
+                const char* start = p;
+                for (; p < end && *p >= '0' && *p <= '9' && p - start < 9; p++) {
+                    if (p - start < 6) { f.micros = f.micros * 10 + (*p - '0'); }
+                }
+                if (p == start) {
+                    return false;
+                }
+                for (long digits = (long)(p - start); digits < 6; digits++) {
+                    f.micros *= 10;
+                }
+            }
+        }
+        if (f.hour > 23 || f.minute > 59 || f.second > 59) {
+            return false;
+        }
+    }
+
+    if (p < end && (*p == '+' || *p == '-')) {
+        f.has_offset = true;
+        int sign = *p++ == '-' ? -1 : 1;
+        int offset_hours, offset_mins = 0;
+        if (!readDigits(p, end, 2, offset_hours)) {
+            return false;
+        }
+        readChar(p, end, ':');
+        if (p < end && !readDigits(p, end, 2, offset_mins)) {
+            return false;
+        }
+        f.offset_minutes = sign * (offset_hours * 60 + offset_mins);
+    } else if (readChar(p, end, 'Z')) {
+        f.has_offset = true;
+    }
+    return p == end;
+}
+
+// Seconds since 1970-01-01 00:00 of the fields as written, less any offset.
+static long long civilSeconds(const TimestampFields& f) {
+    return daysFromCivil(f.year, f.month, f.day) * 86400LL + f.hour * 3600 + f.minute * 60 + f.second
+           - f.offset_minutes * 60LL;
+}
+
+bool parseTimestamp(const char* text, size_t length, double& epoch_ms) {
+    TimestampFields f;
+    if (!parseFields(text, length, f)) {
+        return false;
+    }
+    long long seconds;
+    if (f.has_offset || !f.has_time) {
+        seconds = civilSeconds(f);
+    } else if (!localSeconds(f.year, f.month, f.day, f.hour, f.minute, f.second, seconds)) {
+        return false;
+    }
+    // Digits past milliseconds are dropped, as Date does.
+    epoch_ms = (double)(seconds * 1000 + f.micros / 1000);
+    return true;
+}
+
+bool parseWallClock(const char* text, size_t length, int64_t& micros) {
+    TimestampFields f;
+    if (!parseFields(text, length, f)) {
+        return false;
+    }
+    micros = (int64_t)civilSeconds(f) * 1000000 + f.micros;
+    return true;
+}
+
+size_t formatTimestamp(double epoch_ms, char* out) {
+    double ms = std::floor(epoch_ms);
+    long long days = (long long)std::floor(ms / 86400000.0);
+    long long rest = (long long)(ms - (double)days * 86400000.0);
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+    int length = snprintf(out, 32, year >= 0 && year <= 9999 ? "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ" : "%+07d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                          year, month, day, (int)(rest / 3600000), (int)(rest / 60000 % 60), (int)(rest / 1000 % 60), (int)(rest % 1000));
+    return length > 0 ? (size_t)length : 0;
+}
@@ -26,6 +26,10 @@ void throwNapiError(Napi::Env env, const std::string& msg) {
     Napi::Error::New(env, msg).ThrowAsJavaScriptException();
 }
 
+void throwNapiTypeError(Napi::Env env, const std::string& msg) {
+    Napi::TypeError::New(env, msg).ThrowAsJavaScriptException();
+}
+
 void throwNapiError(Napi::Env env, int code) {
     std::string message;
     getErrorMsg(code, message);